@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <merge.hpp>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -7,6 +8,8 @@
 #include <algorithm>
 #include <ranges>
 #include <numeric>
+#include <span>
+#include <unordered_set>
 
 using namespace std::literals;
 
@@ -134,11 +137,47 @@ TEST_CASE("constexpr extensions")
     REQUIRE(true);
 }
 
+template <std::ranges::input_range... TRng_>
+auto avg_for_unique_hashed(const TRng_&... rng)
+{
+    using TElement = std::common_type_t<std::ranges::range_value_t<TRng_>...>;
+
+    std::unordered_set<TElement> unique_items;
+    unique_items.reserve((rng.size() + ...));
+    (unique_items.insert(rng.begin(), rng.end()), ...);
+
+    auto sum = std::accumulate(unique_items.begin(), unique_items.end(), TElement{});
+
+    return sum / static_cast<double>(unique_items.size());
+}
+
 template <std::ranges::input_range... TRng_>
 constexpr auto avg_for_unique(const TRng_&... rng)
 {
     using TElement = std::common_type_t<std::ranges::range_value_t<TRng_>...>;
 
+    // sorted inputs (e.g. sorted shards) - lazy k-way merge skipping duplicates, nothing is copied or sorted
+    if constexpr (requires { helpers::merging::runs_of(rng...); })
+    {
+        if ((std::ranges::is_sorted(rng) && ...))
+        {
+            TElement sum{};
+            size_t count = 0;
+
+            for (const auto& item : helpers::merging::merge_unique(helpers::merging::runs_of(rng...)))
+            {
+                sum += item;
+                ++count;
+            }
+
+            return sum / static_cast<double>(count);
+        }
+    }
+
+    // unsorted inputs - std::unordered_set is not usable at compile time
+    if (!std::is_constant_evaluated())
+        return avg_for_unique_hashed(rng...);
+
     std::vector<TElement> vec;                            // empty vector
     vec.reserve((rng.size() + ...));                      // reserve a buffer - fold expression C++17
     (vec.insert(vec.end(), rng.begin(), rng.end()), ...); // fold expression C++17
@@ -162,6 +201,22 @@ TEST_CASE("avg for unique")
     constexpr std::array lst2 = {5, 6, 7, 8, 9};
 
     constexpr auto avg = avg_for_unique(lst1, lst2);
+    static_assert(avg == 5.0);
 
     std::cout << "AVG: " << avg << "\n";
+
+    SECTION("unsorted inputs")
+    {
+        constexpr std::array lst3 = {9, 6, 8, 7};
+        static_assert(avg_for_unique(lst3, lst1) == avg);
+
+        const std::vector<int> vec = {7, 7, 1, 8, 2, 3, 4};
+        CHECK(avg_for_unique(lst3, vec, lst2) == avg);
+    }
+
+    SECTION("sorted ranges of different types")
+    {
+        const std::vector<int> vec = {2, 4, 6, 8, 10};
+        CHECK(avg_for_unique(lst1, vec, lst2) == 5.5);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,298 @@
+#ifndef ASYNC_GENERATOR_HPP
+#define ASYNC_GENERATOR_HPP
+
+#include "awaitable_traits.hpp"
+#include "frame_allocator.hpp"
+
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace Coroutines
+{
+    // generator that may co_await inside its body - consumed with:
+    //   while (auto item = co_await gen.next()) { ... }
+    // - yielded items are buffered; the producer runs ahead of the consumer by at most buffer_size items
+    //   and is suspended on co_yield when the buffer is full
+    // - when the producer suspends on co_await (e.g. I/O) a waiting consumer takes over the thread,
+    //   a paused producer continues when the consumer has drained the buffer
+    // - producer and consumer may run on different threads
+    // - the generator may be destroyed only when the producer is not running nor awaiting
+    template <typename T>
+    class [[nodiscard]] AsyncGenerator
+    {
+    public:
+        struct promise_type;
+
+        using CoroutineHandle = std::coroutine_handle<promise_type>;
+
+        struct promise_type : PooledPromise
+        {
+            AsyncGenerator get_return_object() noexcept
+            {
+                return AsyncGenerator{CoroutineHandle::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept { return instrumented(std::suspend_always{}); }
+
+            auto final_suspend() noexcept
+            {
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept { return false; }
+
+                    std::coroutine_handle<> await_suspend(CoroutineHandle producer) noexcept
+                    {
+                        auto& promise = producer.promise();
+
+                        std::lock_guard lk{promise.mtx_};
+                        promise.done_ = true;
+                        return promise.take_consumer();
+                    }
+
+                    void await_resume() const noexcept { }
+                };
+
+                return instrumented(FinalAwaiter{});
+            }
+
+            template <typename U>
+                requires std::constructible_from<T, U&&>
+            auto yield_value(U&& value)
+            {
+                struct YieldAwaiter
+                {
+                    promise_type& promise;
+
+                    bool await_ready() const
+                    {
+                        std::lock_guard lk{promise.mtx_};
+                        return promise.buffer_.size() < promise.buffer_size_; // keep running ahead
+                    }
+
+                    std::coroutine_handle<> await_suspend(CoroutineHandle producer)
+                    {
+                        std::lock_guard lk{promise.mtx_};
+
+                        if (promise.buffer_.size() < promise.buffer_size_) // drained in the meantime by a consumer on another thread
+                            return producer;
+
+                        promise.paused_producer_ = producer;
+                        return promise.take_consumer();
+                    }
+
+                    void await_resume() const noexcept { }
+                };
+
+                {
+                    std::lock_guard lk{mtx_};
+                    buffer_.emplace_back(std::forward<U>(value));
+                }
+
+                return instrumented(YieldAwaiter{*this});
+            }
+
+            void return_void() const noexcept { }
+
+            void unhandled_exception() noexcept
+            {
+                std::lock_guard lk{mtx_};
+                exception_ = std::current_exception();
+            }
+
+            // every co_await in the body hands the thread over to a waiting consumer after suspending
+            template <typename TAwaitable>
+            auto await_transform(TAwaitable&& awaitable)
+            {
+                struct HandOverAwaiter
+                {
+                    awaiter_t<TAwaitable&&> awaiter;
+
+                    bool await_ready() { return awaiter.await_ready(); }
+
+                    std::coroutine_handle<> await_suspend(CoroutineHandle producer)
+                    {
+                        promise_type& promise = producer.promise();
+
+                        std::coroutine_handle<> consumer;
+                        {
+                            std::lock_guard lk{promise.mtx_};
+                            if (!promise.buffer_.empty())
+                                consumer = std::exchange(promise.consumer_, nullptr);
+                        }
+
+                        // once suspended the producer may be resumed (and finish) on another thread - the promise is not touched afterwards
+                        std::coroutine_handle<> next;
+                        try
+                        {
+                            next = suspend_and_get_next(awaiter, producer);
+                        }
+                        catch (...)
+                        {
+                            promise.restore_consumer(consumer);
+                            throw;
+                        }
+
+                        if (next == std::noop_coroutine())
+                            return consumer ? consumer : next;
+
+                        promise.restore_consumer(consumer); // the producer was not handed over - it continues on this thread
+                        return next;
+                    }
+
+                    decltype(auto) await_resume() { return awaiter.await_resume(); }
+                };
+
+                return instrumented(HandOverAwaiter{get_awaiter(std::forward<TAwaitable>(awaitable))});
+            }
+
+        private:
+            friend class AsyncGenerator;
+
+            std::mutex mtx_;
+            std::deque<T> buffer_;
+            std::size_t buffer_size_ = 1;
+            std::coroutine_handle<> consumer_;        // waiting for an item
+            std::coroutine_handle<> paused_producer_; // not started yet or suspended on a full buffer
+            bool done_ = false;
+            std::exception_ptr exception_;
+
+            void restore_consumer(std::coroutine_handle<> consumer)
+            {
+                if (!consumer)
+                    return;
+
+                std::lock_guard lk{mtx_};
+                consumer_ = consumer;
+            }
+
+            std::coroutine_handle<> take_consumer() noexcept
+            {
+                if (auto consumer = std::exchange(consumer_, nullptr))
+                    return consumer;
+                return std::noop_coroutine();
+            }
+        };
+
+        AsyncGenerator(const AsyncGenerator&) = delete;
+        AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+
+        AsyncGenerator(AsyncGenerator&& other) noexcept
+            : coroutine_hndl_{std::exchange(other.coroutine_hndl_, nullptr)}
+        { }
+
+        AsyncGenerator& operator=(AsyncGenerator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (coroutine_hndl_)
+                    coroutine_hndl_.destroy();
+                coroutine_hndl_ = std::exchange(other.coroutine_hndl_, nullptr);
+            }
+            return *this;
+        }
+
+        ~AsyncGenerator()
+        {
+            if (coroutine_hndl_)
+                coroutine_hndl_.destroy();
+        }
+
+        // must be called before the first next()
+        AsyncGenerator& set_buffer_size(std::size_t buffer_size) & noexcept
+        {
+            assert(buffer_size > 0);
+            coroutine_hndl_.promise().buffer_size_ = buffer_size;
+            return *this;
+        }
+
+        AsyncGenerator&& set_buffer_size(std::size_t buffer_size) && noexcept
+        {
+            return std::move(set_buffer_size(buffer_size));
+        }
+
+        std::size_t buffer_size() const noexcept
+        {
+            return coroutine_hndl_.promise().buffer_size_;
+        }
+
+        // co_await gen.next() - std::nullopt when the generator is exhausted
+        auto next() noexcept
+        {
+            struct NextAwaiter
+            {
+                promise_type& promise;
+                std::optional<T> item = std::nullopt;
+                bool exhausted = false;
+
+                bool await_ready() const noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer)
+                {
+                    std::lock_guard lk{promise.mtx_};
+
+                    if (!promise.buffer_.empty())
+                    {
+                        item.emplace(std::move(promise.buffer_.front()));
+                        promise.buffer_.pop_front();
+                        return consumer;
+                    }
+
+                    if (promise.done_)
+                    {
+                        exhausted = true;
+                        return consumer;
+                    }
+
+                    promise.consumer_ = consumer;
+
+                    if (auto producer = std::exchange(promise.paused_producer_, nullptr))
+                        return producer;
+
+                    return std::noop_coroutine(); // the producer is awaiting something - it will hand over when it yields
+                }
+
+                std::optional<T> await_resume()
+                {
+                    if (item || exhausted)
+                        return rethrow_if_failed(std::move(item));
+
+                    std::lock_guard lk{promise.mtx_}; // resumed by the producer
+                    if (promise.buffer_.empty())
+                        return rethrow_if_failed(std::nullopt);
+
+                    std::optional<T> result{std::move(promise.buffer_.front())};
+                    promise.buffer_.pop_front();
+                    return result;
+                }
+
+                std::optional<T> rethrow_if_failed(std::optional<T> result)
+                {
+                    if (!result && promise.exception_)
+                        std::rethrow_exception(std::exchange(promise.exception_, nullptr));
+                    return result;
+                }
+            };
+
+            assert(coroutine_hndl_);
+            return NextAwaiter{coroutine_hndl_.promise()};
+        }
+
+    private:
+        explicit AsyncGenerator(CoroutineHandle coroutine_hndl) noexcept
+            : coroutine_hndl_{coroutine_hndl}
+        {
+            coroutine_hndl_.promise().paused_producer_ = coroutine_hndl_;
+        }
+
+        CoroutineHandle coroutine_hndl_ = nullptr;
+    };
+} // namespace Coroutines
+
+#endif
@@ -0,0 +1,118 @@
+#include "async_generator.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Coroutines::AsyncGenerator;
+using Coroutines::Task;
+
+Task<int> square(int x)
+{
+    co_return x * x;
+}
+
+AsyncGenerator<int> squares(int n)
+{
+    for (int i = 1; i <= n; ++i)
+        co_yield co_await square(i);
+}
+
+Task<std::vector<int>> collect(AsyncGenerator<int> gen)
+{
+    std::vector<int> items;
+    while (auto item = co_await gen.next())
+        items.push_back(*item);
+    co_return items;
+}
+
+TEST_CASE("async generator - co_await in the body")
+{
+    CHECK(Coroutines::sync_wait(collect(squares(5))) == std::vector{1, 4, 9, 16, 25});
+    CHECK(Coroutines::sync_wait(collect(squares(0))).empty());
+}
+
+TEST_CASE("async generator - bounded buffer")
+{
+    int produced = 0;
+
+    auto counting = [](int& produced) -> AsyncGenerator<int> {
+        for (int i = 0; i < 20; ++i)
+        {
+            ++produced;
+            co_yield i;
+        }
+    };
+
+    auto consume = [](AsyncGenerator<int> gen, const int& produced) -> Task<int> {
+        int consumed = 0;
+        int max_run_ahead = 0;
+
+        while (auto item = co_await gen.next())
+        {
+            ++consumed;
+            max_run_ahead = std::max(max_run_ahead, produced - consumed);
+        }
+
+        co_return max_run_ahead;
+    };
+
+    auto gen = counting(produced).set_buffer_size(4);
+    REQUIRE(gen.buffer_size() == 4);
+
+    const int max_run_ahead = Coroutines::sync_wait(consume(std::move(gen), produced));
+
+    CHECK(produced == 20);
+    CHECK(max_run_ahead == 3); // one item taken out of the full buffer
+}
+
+TEST_CASE("async generator - producer on a thread pool")
+{
+    helpers::ThreadPool pool{4};
+
+    auto producer = [](helpers::ThreadPool& pool, int n) -> AsyncGenerator<std::string> {
+        for (int i = 0; i < n; ++i)
+        {
+            co_await Coroutines::schedule_on(pool);
+            co_yield std::to_string(i);
+        }
+    };
+
+    auto consumer = [](AsyncGenerator<std::string> gen) -> Task<long> {
+        long sum = 0;
+        while (auto item = co_await gen.next())
+            sum += std::stol(*item);
+        co_return sum;
+    };
+
+    CHECK(Coroutines::sync_wait(consumer(producer(pool, 10'000).set_buffer_size(16))) == 10'000L * 9'999 / 2);
+}
+
+TEST_CASE("async generator - exception is thrown after buffered items")
+{
+    auto failing = []() -> AsyncGenerator<int> {
+        co_yield 1;
+        co_yield 2;
+        throw std::runtime_error{"producer failed"};
+    };
+
+    auto consumer = [](AsyncGenerator<int> gen) -> Task<int> {
+        int sum = 0;
+        try
+        {
+            while (auto item = co_await gen.next())
+                sum += *item;
+        }
+        catch (const std::runtime_error&)
+        {
+            co_return -sum;
+        }
+        co_return sum;
+    };
+
+    CHECK(Coroutines::sync_wait(consumer(failing().set_buffer_size(8))) == -3);
+}
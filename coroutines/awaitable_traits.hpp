@@ -0,0 +1,67 @@
+#ifndef AWAITABLE_TRAITS_HPP
+#define AWAITABLE_TRAITS_HPP
+
+#include <concepts>
+#include <coroutine>
+#include <type_traits>
+#include <utility>
+
+namespace Coroutines
+{
+    // resumes a coroutine on some execution context - e.g. helpers::ThreadPool
+    template <typename T>
+    concept Scheduler = requires(T& scheduler, std::coroutine_handle<> handle) { scheduler.schedule(handle); };
+
+    namespace detail
+    {
+        template <typename T>
+        concept HasMemberCoAwait = requires(T&& awaitable) { std::forward<T>(awaitable).operator co_await(); };
+
+        template <typename T>
+        concept HasFreeCoAwait = requires(T&& awaitable) { operator co_await(std::forward<T>(awaitable)); };
+    } // namespace detail
+
+    // awaiter obtained from an awaitable the way the co_await expression does it (without await_transform)
+    template <typename T>
+    decltype(auto) get_awaiter(T&& awaitable)
+    {
+        if constexpr (detail::HasMemberCoAwait<T>)
+            return std::forward<T>(awaitable).operator co_await();
+        else if constexpr (detail::HasFreeCoAwait<T>)
+            return operator co_await(std::forward<T>(awaitable));
+        else
+            return std::forward<T>(awaitable);
+    }
+
+    template <typename T>
+    using awaiter_t = decltype(get_awaiter(std::declval<T>()));
+
+    template <typename T>
+    using await_result_t = decltype(std::declval<std::remove_reference_t<awaiter_t<T>>&>().await_resume());
+
+    // calls await_suspend and normalizes its result (void/bool/handle) to the handle that should run next
+    // - noop_coroutine() means: the awaiting coroutine stays suspended and nothing else is resumed
+    template <typename TAwaiter, typename TPromise>
+    std::coroutine_handle<> suspend_and_get_next(TAwaiter& awaiter, std::coroutine_handle<TPromise> awaiting)
+    {
+        using TResult = decltype(awaiter.await_suspend(awaiting));
+
+        if constexpr (std::is_void_v<TResult>)
+        {
+            awaiter.await_suspend(awaiting);
+            return std::noop_coroutine();
+        }
+        else if constexpr (std::same_as<TResult, bool>)
+        {
+            if (awaiter.await_suspend(awaiting))
+                return std::noop_coroutine();
+            return awaiting;
+        }
+        else
+        {
+            return awaiter.await_suspend(awaiting);
+        }
+    }
+} // namespace Coroutines
+
+#endif
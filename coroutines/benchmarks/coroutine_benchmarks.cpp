@@ -0,0 +1,261 @@
+#include "frame_allocator.hpp"
+#include "generator.hpp"
+#include "task.hpp"
+#include "task_resumer.hpp"
+#include "thread_pool.hpp"
+
+#include <array>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+// build & run: cmake --build . --target bench-coroutines && ./coroutines/bench-coroutines
+// - not registered with ctest; compare results only between runs of the same (optimized) build
+
+using Coroutines::Task;
+using Coroutines::TaskResumer;
+
+namespace
+{
+    constexpr int item_count = 10'000;
+    constexpr int handoff_count = 1'000;
+
+    FutureStd::Generator<int> iota_generator(int count)
+    {
+        for (int value = 0; value < count; ++value)
+            co_yield value;
+    }
+
+    // hand-written equivalent of iota_generator
+    class IotaRange
+    {
+    public:
+        class iterator
+        {
+        public:
+            using value_type = int;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(int value) noexcept
+                : value_{value}
+            { }
+
+            int operator*() const noexcept { return value_; }
+
+            iterator& operator++() noexcept
+            {
+                ++value_;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                return iterator{value_++};
+            }
+
+            bool operator==(const iterator&) const = default;
+
+        private:
+            int value_ = 0;
+        };
+
+        explicit IotaRange(int count) noexcept
+            : count_{count}
+        { }
+
+        iterator begin() const noexcept { return iterator{0}; }
+        iterator end() const noexcept { return iterator{count_}; }
+
+    private:
+        int count_;
+    };
+
+    // not reducible to a closed form - the compiler has to visit every item
+    template <typename TRange>
+    std::uint64_t checksum(TRange&& range)
+    {
+        std::uint64_t result = 0;
+        for (int value : range)
+            result = result * 31 + static_cast<std::uint64_t>(value);
+        return result;
+    }
+
+    TaskResumer suspend_forever()
+    {
+        while (true)
+            co_await std::suspend_always{};
+    }
+
+    struct GlobalNewPromise
+    {
+    };
+
+    // lazily started coroutine whose frame is allocated via TPromiseBase
+    template <typename TPromiseBase>
+    class Frame
+    {
+    public:
+        struct promise_type : TPromiseBase
+        {
+            Frame get_return_object() noexcept { return Frame{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            std::suspend_always final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept { }
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+        ~Frame()
+        {
+            coroutine_hndl_.destroy();
+        }
+
+        bool is_ready() const noexcept
+        {
+            return coroutine_hndl_.done();
+        }
+
+    private:
+        explicit Frame(std::coroutine_handle<promise_type> coroutine_hndl) noexcept
+            : coroutine_hndl_{coroutine_hndl}
+        { }
+
+        std::coroutine_handle<promise_type> coroutine_hndl_;
+    };
+
+    template <typename TPromiseBase>
+    Frame<TPromiseBase> make_frame(int value)
+    {
+        std::array<int, 32> locals{}; // lives across the suspension point - stored in the frame
+        locals[0] = value;
+        co_await std::suspend_always{};
+        locals[1] = locals[0];
+    }
+
+    Task<int> bounce(helpers::ThreadPool& ping, helpers::ThreadPool& pong, int handoffs)
+    {
+        for (int i = 0; i < handoffs / 2; ++i)
+        {
+            co_await Coroutines::schedule_on(ping);
+            co_await Coroutines::schedule_on(pong);
+        }
+
+        co_return handoffs;
+    }
+
+    // two threads passing the turn to each other with a mutex and a condition variable
+    class ConditionVariablePingPong
+    {
+    public:
+        ConditionVariablePingPong()
+            : partner_{[this](std::stop_token stop) { serve(stop); }}
+        { }
+
+        int run(int handoffs)
+        {
+            std::unique_lock lk{mtx_};
+
+            for (int i = 0; i < handoffs / 2; ++i)
+            {
+                partners_turn_ = true;
+                cv_.notify_one();
+                cv_.wait(lk, [this] { return !partners_turn_; });
+            }
+
+            return handoffs;
+        }
+
+    private:
+        std::mutex mtx_;
+        std::condition_variable_any cv_;
+        bool partners_turn_ = false;
+        std::jthread partner_; // last - stopped and joined first
+
+        void serve(std::stop_token stop)
+        {
+            std::unique_lock lk{mtx_};
+
+            while (cv_.wait(lk, stop, [this] { return partners_turn_; }))
+            {
+                partners_turn_ = false;
+                cv_.notify_one();
+            }
+        }
+    };
+}
+
+TEST_CASE("generator iteration vs hand-written iterator", "[benchmark]")
+{
+    REQUIRE(checksum(iota_generator(item_count)) == checksum(IotaRange{item_count}));
+
+    BENCHMARK("Generator<int> - 10'000 items")
+    {
+        return checksum(iota_generator(item_count));
+    };
+
+    BENCHMARK("hand-written iterator - 10'000 items")
+    {
+        return checksum(IotaRange{item_count});
+    };
+}
+
+TEST_CASE("resume overhead vs callbacks", "[benchmark]")
+{
+    TaskResumer task = suspend_forever();
+
+    BENCHMARK("TaskResumer::resume")
+    {
+        return task.resume();
+    };
+
+    std::function<int()> callback = [counter = 0]() mutable { return ++counter; };
+
+    BENCHMARK("std::function<int()> call")
+    {
+        return callback();
+    };
+}
+
+TEST_CASE("frame allocation with and without pooling", "[benchmark]")
+{
+    BENCHMARK("create + destroy - PooledPromise")
+    {
+        return make_frame<Coroutines::PooledPromise>(42).is_ready();
+    };
+
+    BENCHMARK("create + destroy - global operator new")
+    {
+        return make_frame<GlobalNewPromise>(42).is_ready();
+    };
+}
+
+TEST_CASE("cross-thread handoff latency", "[benchmark]")
+{
+    helpers::ThreadPool ping{1};
+    helpers::ThreadPool pong{1};
+
+    BENCHMARK("coroutine - schedule_on between two threads - 1'000 handoffs")
+    {
+        return Coroutines::sync_wait(bounce(ping, pong, handoff_count));
+    };
+
+    ConditionVariablePingPong ping_pong;
+
+    BENCHMARK("std::condition_variable ping-pong - 1'000 handoffs")
+    {
+        return ping_pong.run(handoff_count);
+    };
+}
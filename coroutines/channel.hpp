@@ -0,0 +1,444 @@
+#ifndef CHANNEL_HPP
+#define CHANNEL_HPP
+
+#include "awaitable_traits.hpp"
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Coroutines
+{
+    namespace detail
+    {
+        inline constexpr std::size_t cache_line_size = 64;
+
+        template <typename T>
+        class Slot
+        {
+        public:
+            template <typename... TArgs>
+            void construct(TArgs&&... args)
+            {
+                ::new (storage_) T(std::forward<TArgs>(args)...);
+            }
+
+            T take()
+            {
+                T& item = *std::launder(reinterpret_cast<T*>(storage_));
+                T result{std::move(item)};
+                item.~T();
+                return result;
+            }
+
+            void destroy() noexcept
+            {
+                std::launder(reinterpret_cast<T*>(storage_))->~T();
+            }
+
+        private:
+            alignas(T) std::byte storage_[sizeof(T)];
+        };
+
+        // bounded ring buffer for one producer and one consumer
+        template <typename T, std::size_t Capacity>
+        class SpscQueue
+        {
+            static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+        public:
+            SpscQueue() = default;
+            SpscQueue(const SpscQueue&) = delete;
+            SpscQueue& operator=(const SpscQueue&) = delete;
+
+            ~SpscQueue()
+            {
+                for (auto head = head_.load(); head != tail_.load(); ++head)
+                    slots_[head & mask].destroy();
+            }
+
+            // item is moved from only on success
+            bool try_push(T& item)
+            {
+                const std::size_t tail = tail_.load(std::memory_order_relaxed);
+
+                if (tail - cached_head_ == Capacity)
+                {
+                    cached_head_ = head_.load(std::memory_order_acquire);
+                    if (tail - cached_head_ == Capacity)
+                        return false;
+                }
+
+                slots_[tail & mask].construct(std::move(item));
+                tail_.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            std::optional<T> try_pop()
+            {
+                const std::size_t head = head_.load(std::memory_order_relaxed);
+
+                if (head == cached_tail_)
+                {
+                    cached_tail_ = tail_.load(std::memory_order_acquire);
+                    if (head == cached_tail_)
+                        return std::nullopt;
+                }
+
+                std::optional<T> item{slots_[head & mask].take()};
+                head_.store(head + 1, std::memory_order_release);
+                return item;
+            }
+
+        private:
+            static constexpr std::size_t mask = Capacity - 1;
+
+            alignas(cache_line_size) std::atomic<std::size_t> head_{0};
+            std::size_t cached_tail_ = 0; // consumer's copy of tail_
+            alignas(cache_line_size) std::atomic<std::size_t> tail_{0};
+            std::size_t cached_head_ = 0; // producer's copy of head_
+            alignas(cache_line_size) std::unique_ptr<Slot<T>[]> slots_{new Slot<T>[Capacity]};
+        };
+
+        // bounded MPMC queue - D. Vyukov's algorithm, every cell carries a sequence number
+        // - sequences advance in half steps: 2 * position - free for the push at position, 2 * position + 1 - holds its item;
+        //   with whole steps a single cell could not tell "free for position" from "holds position - 1"
+        template <typename T, std::size_t Capacity>
+        class MpmcQueue
+        {
+            static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+        public:
+            MpmcQueue()
+            {
+                for (std::size_t i = 0; i < Capacity; ++i)
+                    cells_[i].sequence.store(2 * i, std::memory_order_relaxed);
+            }
+
+            MpmcQueue(const MpmcQueue&) = delete;
+            MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+            ~MpmcQueue()
+            {
+                while (try_pop())
+                { }
+            }
+
+            // item is moved from only on success
+            bool try_push(T& item)
+            {
+                std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+
+                while (true)
+                {
+                    Cell& cell = cells_[position & mask];
+                    const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::intptr_t>(sequence - 2 * position);
+
+                    if (diff == 0)
+                    {
+                        if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            cell.slot.construct(std::move(item));
+                            cell.sequence.store(2 * position + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0)
+                        return false; // full
+                    else
+                        position = enqueue_position_.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::optional<T> try_pop()
+            {
+                std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+
+                while (true)
+                {
+                    Cell& cell = cells_[position & mask];
+                    const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::intptr_t>(sequence - (2 * position + 1));
+
+                    if (diff == 0)
+                    {
+                        if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            std::optional<T> item{cell.slot.take()};
+                            cell.sequence.store(2 * (position + Capacity), std::memory_order_release);
+                            return item;
+                        }
+                    }
+                    else if (diff < 0)
+                        return std::nullopt; // empty
+                    else
+                        position = dequeue_position_.load(std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            static constexpr std::size_t mask = Capacity - 1;
+
+            struct Cell
+            {
+                std::atomic<std::size_t> sequence;
+                Slot<T> slot;
+            };
+
+            alignas(cache_line_size) std::atomic<std::size_t> enqueue_position_{0};
+            alignas(cache_line_size) std::atomic<std::size_t> dequeue_position_{0};
+            alignas(cache_line_size) std::unique_ptr<Cell[]> cells_{new Cell[Capacity]};
+        };
+
+        // awaitable channel over a lock-free queue
+        // - fast path: try_push/try_pop on the queue + a check of the waiter counters
+        // - slow path: waiters are registered under a mutex; whoever makes progress possible
+        //   completes the waiter (moves the item in/out of its awaiter) and schedules it
+        template <typename T, typename TQueue>
+        class BasicChannel
+        {
+        public:
+            template <Scheduler TScheduler>
+            explicit BasicChannel(TScheduler& scheduler)
+                : scheduler_{&scheduler}
+                , schedule_{[](void* scheduler, std::coroutine_handle<> handle) { static_cast<TScheduler*>(scheduler)->schedule(handle); }}
+            { }
+
+            BasicChannel(const BasicChannel&) = delete;
+            BasicChannel& operator=(const BasicChannel&) = delete;
+
+            bool try_send(T& item)
+            {
+                if (closed_.load(std::memory_order_relaxed) || !queue_.try_push(item))
+                    return false;
+
+                dispatch_if_waiting();
+                return true;
+            }
+
+            bool try_send(T&& item)
+            {
+                return try_send(item);
+            }
+
+            std::optional<T> try_receive()
+            {
+                auto item = queue_.try_pop();
+                if (item)
+                    dispatch_if_waiting();
+                return item;
+            }
+
+            // co_await channel.send(item) - false if the channel is closed
+            auto send(T item)
+            {
+                return SendAwaiter{*this, std::move(item)};
+            }
+
+            // co_await channel.receive() - std::nullopt when the channel is closed and drained
+            auto receive()
+            {
+                return ReceiveAwaiter{*this};
+            }
+
+            // waiting senders fail, receivers get the remaining items and then std::nullopt
+            void close()
+            {
+                std::vector<std::coroutine_handle<>> ready;
+                {
+                    std::lock_guard lk{waiters_mtx_};
+                    closed_.store(true);
+                    complete_waiters(ready);
+
+                    for (auto* sender : std::exchange(senders_, {}))
+                        ready.push_back(sender->awaiting);
+                    for (auto* receiver : std::exchange(receivers_, {}))
+                        ready.push_back(receiver->awaiting);
+                    waiting_count_.store(0);
+                }
+
+                schedule_all(ready);
+            }
+
+            bool is_closed() const noexcept
+            {
+                return closed_.load();
+            }
+
+        private:
+            struct SendAwaiter
+            {
+                BasicChannel& channel;
+                T item;
+                bool sent = false;
+                std::coroutine_handle<> awaiting = nullptr;
+
+                bool await_ready()
+                {
+                    sent = channel.try_send(item);
+                    return sent || channel.is_closed();
+                }
+
+                bool await_suspend(std::coroutine_handle<> awaiting_coroutine)
+                {
+                    awaiting = awaiting_coroutine;
+
+                    std::unique_lock lk{channel.waiters_mtx_};
+                    channel.waiting_count_.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if (channel.closed_.load() || (sent = channel.queue_.try_push(item))) // recheck - a receiver may have missed us
+                    {
+                        channel.waiting_count_.fetch_sub(1);
+                        lk.unlock();
+                        if (sent)
+                            channel.dispatch_if_waiting();
+                        return false;
+                    }
+
+                    channel.senders_.push_back(this);
+                    return true;
+                }
+
+                bool await_resume() const noexcept { return sent; }
+            };
+
+            struct ReceiveAwaiter
+            {
+                BasicChannel& channel;
+                std::optional<T> item = std::nullopt;
+                std::coroutine_handle<> awaiting = nullptr;
+
+                bool await_ready()
+                {
+                    item = channel.try_receive();
+                    return item.has_value();
+                }
+
+                bool await_suspend(std::coroutine_handle<> awaiting_coroutine)
+                {
+                    awaiting = awaiting_coroutine;
+
+                    std::unique_lock lk{channel.waiters_mtx_};
+                    channel.waiting_count_.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    if ((item = channel.queue_.try_pop()) || channel.closed_.load()) // recheck - a sender may have missed us
+                    {
+                        channel.waiting_count_.fetch_sub(1);
+                        lk.unlock();
+                        if (item)
+                            channel.dispatch_if_waiting();
+                        return false;
+                    }
+
+                    channel.receivers_.push_back(this);
+                    return true;
+                }
+
+                std::optional<T> await_resume() noexcept { return std::move(item); }
+            };
+
+            TQueue queue_;
+
+            void* scheduler_;
+            void (*schedule_)(void*, std::coroutine_handle<>);
+
+            std::atomic<bool> closed_{false};
+            alignas(cache_line_size) std::atomic<std::size_t> waiting_count_{0};
+
+            std::mutex waiters_mtx_;
+            std::deque<SendAwaiter*> senders_;
+            std::deque<ReceiveAwaiter*> receivers_;
+
+            void dispatch_if_waiting()
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (waiting_count_.load(std::memory_order_relaxed) == 0)
+                    return;
+
+                std::vector<std::coroutine_handle<>> ready;
+                {
+                    std::lock_guard lk{waiters_mtx_};
+                    complete_waiters(ready);
+                }
+
+                schedule_all(ready);
+            }
+
+            // under waiters_mtx_ - moves items between waiters and the queue as long as any of them can progress
+            void complete_waiters(std::vector<std::coroutine_handle<>>& ready)
+            {
+                bool progress = true;
+                while (progress)
+                {
+                    progress = false;
+
+                    while (!receivers_.empty())
+                    {
+                        auto item = queue_.try_pop();
+                        if (!item)
+                            break;
+
+                        ReceiveAwaiter* receiver = receivers_.front();
+                        receivers_.pop_front();
+                        waiting_count_.fetch_sub(1);
+
+                        receiver->item = std::move(item);
+                        ready.push_back(receiver->awaiting);
+                        progress = true;
+                    }
+
+                    while (!senders_.empty() && queue_.try_push(senders_.front()->item))
+                    {
+                        SendAwaiter* sender = senders_.front();
+                        senders_.pop_front();
+                        waiting_count_.fetch_sub(1);
+
+                        sender->sent = true;
+                        ready.push_back(sender->awaiting);
+                        progress = true;
+                    }
+                }
+            }
+
+            void schedule_all(const std::vector<std::coroutine_handle<>>& ready)
+            {
+                for (auto handle : ready)
+                    schedule_(scheduler_, handle);
+            }
+        };
+    } // namespace detail
+
+    // single producer, single consumer
+    template <typename T, std::size_t Capacity>
+    class SpscChannel : public detail::BasicChannel<T, detail::SpscQueue<T, Capacity>>
+    {
+    public:
+        using detail::BasicChannel<T, detail::SpscQueue<T, Capacity>>::BasicChannel;
+    };
+
+    // any number of producers and consumers
+    template <typename T, std::size_t Capacity>
+    class MpmcChannel : public detail::BasicChannel<T, detail::MpmcQueue<T, Capacity>>
+    {
+    public:
+        using detail::BasicChannel<T, detail::MpmcQueue<T, Capacity>>::BasicChannel;
+    };
+
+    template <typename T, std::size_t Capacity>
+    using Channel = MpmcChannel<T, Capacity>;
+} // namespace Coroutines
+
+#endif
@@ -0,0 +1,155 @@
+#include "channel.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Coroutines::Task;
+
+TEST_CASE("channel - try_send & try_receive")
+{
+    helpers::ThreadPool pool{1};
+    Coroutines::Channel<std::unique_ptr<int>, 2> channel{pool};
+
+    CHECK(channel.try_send(std::make_unique<int>(1)));
+    CHECK(channel.try_send(std::make_unique<int>(2)));
+
+    auto rejected = std::make_unique<int>(3);
+    CHECK_FALSE(channel.try_send(rejected)); // full
+    CHECK(rejected != nullptr);              // not moved from
+
+    CHECK(*channel.try_receive().value() == 1);
+    CHECK(*channel.try_receive().value() == 2);
+    CHECK_FALSE(channel.try_receive());
+}
+
+TEST_CASE("channel - a single slot")
+{
+    helpers::ThreadPool pool{1};
+    Coroutines::Channel<int, 1> channel{pool};
+
+    CHECK(channel.try_send(1));
+    CHECK_FALSE(channel.try_send(2)); // full - the item is not overwritten
+
+    CHECK(channel.try_receive() == 1);
+    CHECK_FALSE(channel.try_receive());
+
+    CHECK(channel.try_send(3));
+    CHECK(channel.try_receive() == 3);
+}
+
+template <typename TChannel>
+Task<int> produce(TChannel& channel, int first, int count)
+{
+    int sent = 0;
+    for (int i = first; i < first + count; ++i)
+        sent += co_await channel.send(i);
+    co_return sent;
+}
+
+template <typename TChannel>
+Task<long> consume(TChannel& channel, int count)
+{
+    long sum = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        auto item = co_await channel.receive();
+        sum += item.value();
+    }
+    co_return sum;
+}
+
+TEST_CASE("channel - spsc between threads")
+{
+    constexpr int count = 100'000;
+
+    helpers::ThreadPool pool{2};
+    Coroutines::SpscChannel<int, 64> channel{pool};
+
+    int sent = 0;
+    std::jthread producer{[&] { sent = Coroutines::sync_wait(produce(channel, 0, count)); }};
+    const long sum = Coroutines::sync_wait(consume(channel, count));
+    producer.join();
+
+    CHECK(sent == count);
+    CHECK(sum == static_cast<long>(count) * (count - 1) / 2);
+}
+
+TEST_CASE("channel - mpmc between threads")
+{
+    constexpr int producer_count = 4;
+    constexpr int consumer_count = 3;
+    constexpr int items_per_producer = 30'000;
+    constexpr int items_per_consumer = producer_count * items_per_producer / consumer_count;
+
+    helpers::ThreadPool pool{4};
+    Coroutines::MpmcChannel<int, 16> channel{pool};
+
+    std::vector<int> sent(producer_count);
+    std::vector<long> sums(consumer_count);
+    {
+        std::vector<std::jthread> producers;
+        for (int p = 0; p < producer_count; ++p)
+            producers.emplace_back([&, p] { sent[p] = Coroutines::sync_wait(produce(channel, p * items_per_producer, items_per_producer)); });
+
+        std::vector<std::jthread> consumers;
+        for (int c = 0; c < consumer_count; ++c)
+            consumers.emplace_back([&, c] { sums[c] = Coroutines::sync_wait(consume(channel, items_per_consumer)); });
+    }
+
+    const long total = producer_count * items_per_producer;
+    CHECK(std::accumulate(sent.begin(), sent.end(), 0L) == total);
+    CHECK(std::accumulate(sums.begin(), sums.end(), 0L) == total * (total - 1) / 2);
+}
+
+TEST_CASE("channel - mpmc with a single slot between threads")
+{
+    constexpr int items_per_producer = 10'000;
+
+    helpers::ThreadPool pool{4};
+    Coroutines::MpmcChannel<int, 1> channel{pool};
+
+    int sent[2] = {};
+    long sum = 0;
+    {
+        std::jthread first{[&] { sent[0] = Coroutines::sync_wait(produce(channel, 0, items_per_producer)); }};
+        std::jthread second{[&] { sent[1] = Coroutines::sync_wait(produce(channel, items_per_producer, items_per_producer)); }};
+        sum = Coroutines::sync_wait(consume(channel, 2 * items_per_producer));
+    }
+
+    const long total = 2 * items_per_producer;
+    CHECK(sent[0] + sent[1] == total);
+    CHECK(sum == total * (total - 1) / 2);
+}
+
+TEST_CASE("channel - close")
+{
+    helpers::ThreadPool pool{2};
+    Coroutines::Channel<std::string, 4> channel{pool};
+
+    auto drain = [](Coroutines::Channel<std::string, 4>& channel) -> Task<std::vector<std::string>> {
+        std::vector<std::string> items;
+        while (auto item = co_await channel.receive())
+            items.push_back(*item);
+        co_return items;
+    };
+
+    std::jthread closer{[&] {
+        Coroutines::sync_wait([](Coroutines::Channel<std::string, 4>& channel) -> Task<void> {
+            co_await channel.send("one");
+            co_await channel.send("two");
+        }(channel));
+        channel.close();
+    }};
+
+    CHECK(Coroutines::sync_wait(drain(channel)) == std::vector<std::string>{"one", "two"});
+    CHECK(channel.is_closed());
+    CHECK_FALSE(Coroutines::sync_wait([](Coroutines::Channel<std::string, 4>& channel) -> Task<bool> {
+        co_return co_await channel.send("three");
+    }(channel)));
+}
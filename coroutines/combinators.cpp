@@ -0,0 +1,148 @@
+#include "task.hpp"
+#include "thread_pool.hpp"
+#include "when_all.hpp"
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <latch>
+#include <numeric>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+using Coroutines::Task;
+
+namespace
+{
+    Task<int> square(int x)
+    {
+        co_return x * x;
+    }
+
+    Task<int> square_on(helpers::ThreadPool& pool, int x)
+    {
+        co_await Coroutines::schedule_on(pool);
+        co_return x * x;
+    }
+
+    Task<std::string> text(std::string value)
+    {
+        co_return value;
+    }
+
+    Task<> fail_with(std::string message)
+    {
+        throw std::runtime_error{message};
+        co_return;
+    }
+
+    // returns only when stop is requested
+    Task<int> spin_until_stopped(helpers::ThreadPool& pool, std::stop_token stop)
+    {
+        while (!stop.stop_requested())
+            co_await Coroutines::schedule_on(pool);
+
+        co_return -1;
+    }
+}
+
+TEST_CASE("when_all - tuple of results")
+{
+    bool done = false;
+
+    auto mark_done = [](bool& done) -> Task<> {
+        done = true;
+        co_return;
+    };
+
+    auto [number, str, nothing] = Coroutines::sync_wait(Coroutines::when_all(square(3), text("text"), mark_done(done)));
+
+    CHECK(number == 9);
+    CHECK(str == "text");
+    CHECK(nothing == std::monostate{});
+    CHECK(done);
+}
+
+TEST_CASE("when_all - range of tasks started on a thread pool")
+{
+    helpers::ThreadPool pool{4};
+
+    std::vector<Task<int>> tasks;
+    for (int i = 0; i < 1000; ++i)
+        tasks.push_back(square_on(pool, i));
+
+    auto results = Coroutines::sync_wait(Coroutines::when_all(pool, std::move(tasks)));
+
+    REQUIRE(results.size() == 1000);
+    CHECK(results[10] == 100);
+    CHECK(std::accumulate(results.begin(), results.end(), 0LL) == 332'833'500);
+}
+
+TEST_CASE("when_all - children run concurrently")
+{
+    helpers::ThreadPool pool{3};
+    std::latch all_started{3};
+
+    auto wait_for_others = [](std::latch& all_started) -> Task<> {
+        all_started.arrive_and_wait(); // deadlocks unless all three run at the same time
+        co_return;
+    };
+
+    Coroutines::sync_wait(Coroutines::when_all(pool, wait_for_others(all_started), wait_for_others(all_started), wait_for_others(all_started)));
+}
+
+TEST_CASE("when_all - exception of the first failed task is rethrown after all tasks finished")
+{
+    std::atomic<int> finished = 0;
+
+    auto counted = [](std::atomic<int>& finished) -> Task<int> {
+        ++finished;
+        co_return 1;
+    };
+
+    std::vector<Task<>> tasks;
+    tasks.push_back(fail_with("first"));
+    tasks.push_back(fail_with("second"));
+
+    CHECK_THROWS_WITH(Coroutines::sync_wait(Coroutines::when_all(std::move(tasks))), "first");
+    CHECK_THROWS_WITH(Coroutines::sync_wait(Coroutines::when_all(counted(finished), fail_with("error"), counted(finished))), "error");
+    CHECK(finished == 2);
+}
+
+TEST_CASE("when_any - first result wins, the others are stopped")
+{
+    helpers::ThreadPool pool{2};
+    std::stop_source stop;
+
+    auto result = Coroutines::sync_wait(Coroutines::when_any(stop, spin_until_stopped(pool, stop.get_token()), spin_until_stopped(pool, stop.get_token()), text("text")));
+
+    CHECK(stop.stop_requested());
+    REQUIRE(result.index() == 2);
+    CHECK(std::get<2>(result) == "text");
+}
+
+TEST_CASE("when_any - range of tasks")
+{
+    helpers::ThreadPool pool{2};
+    std::stop_source stop;
+
+    std::vector<Task<int>> tasks;
+    tasks.push_back(spin_until_stopped(pool, stop.get_token()));
+    tasks.push_back(square_on(pool, 5));
+    tasks.push_back(spin_until_stopped(pool, stop.get_token()));
+
+    auto [index, value] = Coroutines::sync_wait(Coroutines::when_any(pool, stop, std::move(tasks)));
+
+    CHECK(index == 1);
+    CHECK(value == 25);
+}
+
+TEST_CASE("when_any - exception of the winner is rethrown")
+{
+    helpers::ThreadPool pool{2};
+    std::stop_source stop;
+
+    CHECK_THROWS_WITH(Coroutines::sync_wait(Coroutines::when_any(stop, spin_until_stopped(pool, stop.get_token()), fail_with("error"))), "error");
+}
@@ -1,70 +1,21 @@
+#include "frame_allocator.hpp"
+#include "generator.hpp"
+#include "task_resumer.hpp"
+
 #include <catch2/catch_test_macros.hpp>
 #include <coroutine>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
 #include <string>
 #include <vector>
 
 using namespace std::literals;
+using Coroutines::TaskResumer;
 
 // https://github.com/facebookexperimental/libunifex
 
-class TaskResumer
-{
-public:
-    struct promise_type;
-
-    using CoroutineHandle = std::coroutine_handle<promise_type>;
-
-    struct promise_type
-    {
-        TaskResumer get_return_object()
-        {
-            return TaskResumer{CoroutineHandle::from_promise(*this)};
-        }
-
-        std::suspend_always initial_suspend() const noexcept { return {}; }
-
-        std::suspend_always final_suspend() noexcept { return {}; }
-
-        void return_void()
-        { }
-
-        void unhandled_exception()
-        {
-            std::terminate();
-        }
-    };
-
-public:
-    TaskResumer(CoroutineHandle coro_hndl)
-        : coro_hndl_{coro_hndl}
-    { }
-
-    TaskResumer(const TaskResumer&) = delete;
-    TaskResumer& operator=(const TaskResumer&) = delete;
-    TaskResumer(TaskResumer&&) = delete;
-    TaskResumer& operator=(TaskResumer&&) = delete;
-
-    ~TaskResumer() noexcept
-    {
-        if (coro_hndl_)
-            coro_hndl_.destroy();
-    }
-
-    bool resume() const
-    {
-         if (!coro_hndl_ || coro_hndl_.done())
-            return false;
-
-        coro_hndl_.resume(); // resuming suspended coroutine
-
-        return !coro_hndl_.done();
-    }
-
-private:
-    CoroutineHandle coro_hndl_;
-};
-
 TaskResumer foo(int max)
 {
     std::string str = "HELLO";
@@ -92,161 +43,6 @@ TEST_CASE("first coroutine")
     std::cout << "coro() done!\n";
 }
 
-namespace FutureStd
-{
-
-    template <typename T>
-    class [[nodiscard]] Generator
-    {
-    public:
-        struct promise_type;
-
-        using CoroutineHandle = std::coroutine_handle<promise_type>;
-
-        struct promise_type
-        {
-            Generator get_return_object()
-            {
-                return Generator{CoroutineHandle::from_promise(*this)};
-            }
-
-            std::suspend_always initial_suspend() const { return {}; }
-
-            std::suspend_always final_suspend() const noexcept { return {}; }
-
-            void unhandled_exception() { std::terminate(); }
-
-            std::suspend_always yield_value(auto&& yielded_value)
-            {
-                value = std::forward<decltype(yielded_value)>(yielded_value);
-                return {};
-            }
-
-            void return_void() { }
-
-            T value;
-        };
-
-        struct iterator
-        {
-            using value_type = T;
-            using reference = T;
-            using iterator_category = std::input_iterator_tag;
-
-            CoroutineHandle coroutine_handle_ = nullptr;
-
-            iterator() = default;
-
-            iterator(auto coroutine_handle)
-                : coroutine_handle_{coroutine_handle}
-            { }
-
-            T operator*() const
-            {
-                assert(coroutine_handle_ != nullptr);
-                return coroutine_handle_.promise().value;
-            }
-
-            T* operator->() const
-            {
-                assert(coroutine_handle_ != nullptr);
-                return &coroutine_handle_.promise().value;
-            }
-
-            iterator& operator++()
-            {
-                move_to_next();
-                return *this;
-            }
-
-            iterator operator++(int)
-            {
-                iterator prev_pos = *this;
-                move_to_next();
-                return prev_pos;
-            }
-
-            bool operator==(const iterator& other) const = default;
-
-        private:
-            friend class Generator;
-
-            void move_to_next()
-            {
-                if (coroutine_handle_ && !coroutine_handle_.done())
-                {
-                    coroutine_handle_.resume();
-
-                    if (coroutine_handle_.done())
-                    {
-                        coroutine_handle_ = nullptr;
-                    }
-                }
-            }
-        };
-
-        Generator(CoroutineHandle coroutine_hndl)
-            : coroutine_hndl_{coroutine_hndl}
-        { }
-
-        Generator(const Generator&) = delete;
-        Generator& operator=(const Generator&) = delete;
-
-        ~Generator()
-        {
-            if (coroutine_hndl_)
-                coroutine_hndl_.destroy();
-        }
-
-        std::optional<T> next_value()
-        {
-            assert(coroutine_hndl_);
-            // if (!coroutine_hndl_ || coroutine_hndl_.done())
-            //     return std::nullopt;
-
-            coroutine_hndl_.resume();
-
-            if (coroutine_hndl_.done())
-                return std::nullopt;
-
-            return coroutine_hndl_.promise().value;
-        }
-
-        iterator begin() const
-        {
-            if (!coroutine_hndl_ || coroutine_hndl_.done())
-                return {};
-
-            iterator it{coroutine_hndl_};
-            it.next();
-            return it;
-        }
-
-        iterator end() const
-        {
-            return {};
-        }
-
-        iterator begin()
-        {
-            if (!coroutine_hndl_ || coroutine_hndl_.done())
-                return {};
-
-            iterator it{coroutine_hndl_};
-            it.move_to_next();
-            return it;
-        }
-
-        iterator end()
-        {
-            return {};
-        }
-
-    private:
-        CoroutineHandle coroutine_hndl_;
-    };
-} // namespace FutureStd
-
 using FutureStd::Generator;
 
 Generator<int> fibonacci(int n)
@@ -264,4 +60,186 @@ TEST_CASE("fibonacci with generator")
     for (const auto& item : fibonacci(100))
         std::cout << item << " ";
     std::cout << "\n";
-}
\ No newline at end of file
+}
+
+TEST_CASE("generator - pipelines")
+{
+    static_assert(std::ranges::input_range<Generator<int>>);
+    static_assert(std::ranges::view<Generator<int>>);
+
+    auto even_fibs = fibonacci(1'000) | views::filter([](int x) { return x % 2 == 0; }) | views::take(4);
+
+    std::vector<int> result;
+    std::ranges::copy(even_fibs, std::back_inserter(result));
+
+    CHECK(result == std::vector{0, 2, 8, 34});
+}
+
+struct CopyCounter
+{
+    inline static int copies = 0;
+
+    std::vector<int> payload;
+
+    CopyCounter(std::vector<int> payload)
+        : payload{std::move(payload)}
+    { }
+
+    CopyCounter(const CopyCounter& other)
+        : payload{other.payload}
+    {
+        ++copies;
+    }
+
+    CopyCounter(CopyCounter&&) = default;
+};
+
+Generator<const CopyCounter&> lvalues(const std::vector<CopyCounter>& items)
+{
+    for (const auto& item : items)
+        co_yield item;
+}
+
+Generator<CopyCounter> rvalues(int n)
+{
+    for (int i = 0; i < n; ++i)
+        co_yield CopyCounter{std::vector<int>(3, i)};
+}
+
+TEST_CASE("generator - yielded objects are not copied")
+{
+    CopyCounter::copies = 0;
+
+    std::vector<CopyCounter> items = {CopyCounter{{1, 2, 3}}, CopyCounter{{4, 5, 6}}};
+    const int copies_before = CopyCounter::copies;
+
+    int sum = 0;
+    for (const CopyCounter& item : lvalues(items))
+        sum += item.payload.front();
+
+    for (CopyCounter&& item : rvalues(3))
+        sum += std::move(item).payload.back();
+
+    CHECK(sum == 1 + 4 + 0 + 1 + 2);
+    CHECK(CopyCounter::copies == copies_before);
+}
+
+using FutureStd::elements_of;
+
+Generator<int> tree(int depth)
+{
+    if (depth == 0)
+    {
+        co_yield 1;
+        co_return;
+    }
+
+    co_yield elements_of(tree(depth - 1));
+    co_yield depth;
+    co_yield elements_of(tree(depth - 1));
+}
+
+Generator<int> failing_nested()
+{
+    co_yield 1;
+    throw std::runtime_error{"nested error"};
+}
+
+Generator<int> outer_with_failing_nested()
+{
+    co_yield 0;
+    co_yield elements_of(failing_nested());
+    co_yield 2;
+}
+
+TEST_CASE("generator - recursive elements_of")
+{
+    using FutureStd::elements_of;
+
+    SECTION("nested generators")
+    {
+        std::vector<int> values;
+        std::ranges::copy(tree(3), std::back_inserter(values));
+
+        CHECK(values == std::vector{1, 1, 1, 2, 1, 1, 1, 3, 1, 1, 1, 2, 1, 1, 1});
+    }
+
+    SECTION("any range")
+    {
+        auto gen = []() -> Generator<int> {
+            std::vector<int> vec = {1, 2, 3};
+            co_yield elements_of(vec);
+            co_yield elements_of(views::iota(4, 6));
+        }();
+
+        std::vector<int> values;
+        std::ranges::copy(gen, std::back_inserter(values));
+
+        CHECK(values == std::vector{1, 2, 3, 4, 5});
+    }
+
+    SECTION("exception from nested generator is propagated")
+    {
+        auto gen = outer_with_failing_nested();
+        auto it = gen.begin();
+
+        CHECK(*it == 0);
+        ++it;
+        CHECK(*it == 1);
+        CHECK_THROWS_AS(++it, std::runtime_error);
+    }
+}
+
+TEST_CASE("generator - next_value")
+{
+    auto gen = fibonacci(10);
+
+    std::vector<int> values;
+    while (auto value = gen.next_value())
+        values.push_back(*value);
+
+    CHECK(values == std::vector{0, 1, 1, 2, 3, 5, 8});
+}
+
+TEST_CASE("coroutine frames - pooled allocation")
+{
+    auto& pool = Coroutines::FramePool::local();
+
+    {
+        auto gen = fibonacci(10);
+    }
+
+    const auto cached_blocks = pool.cached_blocks();
+    REQUIRE(cached_blocks > 0);
+
+    {
+        auto gen = fibonacci(10); // a frame of the same size class
+        CHECK(pool.cached_blocks() == cached_blocks - 1); // frame reused from the pool
+    }
+
+    CHECK(pool.cached_blocks() == cached_blocks);
+}
+
+Generator<int> iota_in_arena(std::allocator_arg_t, std::pmr::polymorphic_allocator<>, int n)
+{
+    for (int i = 0; i < n; ++i)
+        co_yield i;
+}
+
+TEST_CASE("coroutine frames - allocator-aware generator")
+{
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+    const auto cached_blocks = Coroutines::FramePool::local().cached_blocks();
+
+    int sum = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        for (int value : iota_in_arena(std::allocator_arg, &arena, 10))
+            sum += value;
+    }
+
+    CHECK(sum == 5 * 45);
+    CHECK(Coroutines::FramePool::local().cached_blocks() == cached_blocks);
+}
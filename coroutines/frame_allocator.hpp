@@ -0,0 +1,247 @@
+#ifndef FRAME_ALLOCATOR_HPP
+#define FRAME_ALLOCATOR_HPP
+
+#ifdef COROUTINES_INSTRUMENTATION
+#include "instrumentation.hpp"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Coroutines
+{
+    // every frame is preceded by a header that knows how to release it
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameHeader
+    {
+        void (*deallocate)(FrameHeader* header, std::size_t frame_size);
+    };
+
+    // thread-local free lists of coroutine frames in power-of-two size classes (64 B - 4 KiB)
+    // - a frame freed on another thread is cached by that thread
+    // - larger frames go straight to global operator new
+    class FramePool
+    {
+    public:
+        static constexpr std::size_t min_block_size = 64;
+        static constexpr std::size_t max_block_size = 4096;
+        static constexpr std::size_t max_cached_blocks_per_class = 256;
+
+        static FramePool& local()
+        {
+            thread_local FramePool pool;
+            return pool;
+        }
+
+        FramePool() = default;
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+
+        ~FramePool()
+        {
+            for (auto& free_list : free_lists_)
+            {
+                while (free_list.head)
+                    ::operator delete(std::exchange(free_list.head, free_list.head->next));
+            }
+        }
+
+        void* allocate(std::size_t size)
+        {
+            const std::size_t block_size = std::max(std::bit_ceil(size), min_block_size);
+
+            if (block_size > max_block_size)
+                return ::operator new(size);
+
+            auto& free_list = free_lists_[size_class(block_size)];
+            if (free_list.head)
+            {
+                --free_list.count;
+                return std::exchange(free_list.head, free_list.head->next);
+            }
+
+            return ::operator new(block_size);
+        }
+
+        void deallocate(void* ptr, std::size_t size) noexcept
+        {
+            const std::size_t block_size = std::max(std::bit_ceil(size), min_block_size);
+
+            if (block_size > max_block_size)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            auto& free_list = free_lists_[size_class(block_size)];
+            if (free_list.count == max_cached_blocks_per_class)
+            {
+                ::operator delete(ptr);
+                return;
+            }
+
+            free_list.head = ::new (ptr) FreeBlock{free_list.head};
+            ++free_list.count;
+        }
+
+        std::size_t cached_blocks() const noexcept
+        {
+            std::size_t count = 0;
+            for (const auto& free_list : free_lists_)
+                count += free_list.count;
+            return count;
+        }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct FreeList
+        {
+            FreeBlock* head = nullptr;
+            std::size_t count = 0;
+        };
+
+        static constexpr std::size_t size_class_count = std::bit_width(max_block_size) - std::bit_width(min_block_size) + 1;
+
+        std::array<FreeList, size_class_count> free_lists_{};
+
+        static std::size_t size_class(std::size_t block_size) noexcept
+        {
+            return std::bit_width(block_size) - std::bit_width(min_block_size);
+        }
+    };
+
+    // base class for promise types - coroutine frames are allocated from the thread-local FramePool,
+    // unless the coroutine takes (std::allocator_arg_t, Allocator, ...) as its leading parameters
+    // (or just after the object parameter for member coroutines) - then the allocator is used
+    //
+    // with COROUTINES_INSTRUMENTATION defined (for the whole program) frames report to the CoroutineRegistry:
+    // - the allocating operator new picks up the coroutine function from a defaulted std::source_location
+    // - co_await expressions are instrumented by await_transform, derived promises wrap their
+    //   initial/final suspend and yield awaiters with instrumented()
+    struct PooledPromise
+    {
+#ifdef COROUTINES_INSTRUMENTATION
+        static void* operator new(std::size_t frame_size, std::source_location location = std::source_location::current())
+        {
+            CoroutineProbe::frame_allocated(CoroutineRegistry::instance().stats_for(location), frame_size);
+            return allocate_pooled(frame_size);
+        }
+#else
+        static void* operator new(std::size_t frame_size)
+        {
+            return allocate_pooled(frame_size);
+        }
+#endif
+
+        template <typename TAllocator, typename... TArgs>
+        static void* operator new(std::size_t frame_size, std::allocator_arg_t, const TAllocator& allocator, const TArgs&...)
+        {
+            return allocate_with(allocator, frame_size);
+        }
+
+        template <typename TThis, typename TAllocator, typename... TArgs>
+        static void* operator new(std::size_t frame_size, const TThis&, std::allocator_arg_t, const TAllocator& allocator, const TArgs&...)
+        {
+            return allocate_with(allocator, frame_size);
+        }
+
+        static void operator delete(void* frame, std::size_t frame_size) noexcept
+        {
+            auto* header = static_cast<FrameHeader*>(frame) - 1;
+            header->deallocate(header, frame_size);
+        }
+
+#ifdef COROUTINES_INSTRUMENTATION
+        template <typename TAwaitable>
+        auto await_transform(TAwaitable&& awaitable)
+        {
+            return InstrumentedAwaiter<awaiter_t<TAwaitable&&>>{probe_, get_awaiter(std::forward<TAwaitable>(awaitable))};
+        }
+#endif
+
+    protected:
+        // no-op unless COROUTINES_INSTRUMENTATION is defined
+        template <typename TAwaiter>
+        auto instrumented(TAwaiter awaiter) noexcept(std::is_nothrow_move_constructible_v<TAwaiter>)
+        {
+#ifdef COROUTINES_INSTRUMENTATION
+            return InstrumentedAwaiter<TAwaiter>{probe_, std::move(awaiter)};
+#else
+            return awaiter;
+#endif
+        }
+
+    private:
+#ifdef COROUTINES_INSTRUMENTATION
+        CoroutineProbe probe_;
+#endif
+
+        static void* allocate_pooled(std::size_t frame_size)
+        {
+            auto* header = ::new (FramePool::local().allocate(sizeof(FrameHeader) + frame_size)) FrameHeader{};
+            header->deallocate = [](FrameHeader* header, std::size_t frame_size) {
+                FramePool::local().deallocate(header, sizeof(FrameHeader) + frame_size);
+            };
+
+            return header + 1;
+        }
+
+        // allocation unit - keeps frames aligned even for byte-oriented allocators (e.g. std::pmr)
+        struct alignas(FrameHeader) FrameChunk
+        {
+            std::byte bytes[sizeof(FrameHeader)];
+        };
+
+        // layout: [FrameHeader][frame][padding][allocator copy]
+        template <typename TChunkAllocator>
+        static std::size_t allocator_offset(std::size_t frame_size) noexcept
+        {
+            constexpr std::size_t alignment = alignof(TChunkAllocator);
+            return (sizeof(FrameHeader) + frame_size + alignment - 1) / alignment * alignment;
+        }
+
+        template <typename TChunkAllocator>
+        static std::size_t chunk_count(std::size_t frame_size) noexcept
+        {
+            return (allocator_offset<TChunkAllocator>(frame_size) + sizeof(TChunkAllocator) + sizeof(FrameChunk) - 1) / sizeof(FrameChunk);
+        }
+
+        template <typename TAllocator>
+        static void* allocate_with(const TAllocator& allocator, std::size_t frame_size)
+        {
+            using TChunkAllocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<FrameChunk>;
+            static_assert(alignof(TChunkAllocator) <= alignof(FrameHeader));
+
+            TChunkAllocator chunk_allocator{allocator};
+
+            auto* memory = reinterpret_cast<std::byte*>(
+                std::allocator_traits<TChunkAllocator>::allocate(chunk_allocator, chunk_count<TChunkAllocator>(frame_size)));
+
+            ::new (memory + allocator_offset<TChunkAllocator>(frame_size)) TChunkAllocator{std::move(chunk_allocator)};
+
+            auto* header = ::new (memory) FrameHeader{};
+            header->deallocate = [](FrameHeader* header, std::size_t frame_size) {
+                auto* memory = reinterpret_cast<std::byte*>(header);
+
+                auto* stored_allocator = std::launder(reinterpret_cast<TChunkAllocator*>(memory + allocator_offset<TChunkAllocator>(frame_size)));
+                TChunkAllocator chunk_allocator{std::move(*stored_allocator)};
+                stored_allocator->~TChunkAllocator();
+
+                std::allocator_traits<TChunkAllocator>::deallocate(chunk_allocator, reinterpret_cast<FrameChunk*>(memory), chunk_count<TChunkAllocator>(frame_size));
+            };
+
+            return header + 1;
+        }
+    };
+} // namespace Coroutines
+
+#endif
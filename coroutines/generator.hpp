@@ -0,0 +1,286 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include "frame_allocator.hpp"
+
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace FutureStd
+{
+    template <std::ranges::range TRange>
+    struct elements_of
+    {
+        TRange range;
+    };
+
+    template <typename TRange>
+    elements_of(TRange&&) -> elements_of<TRange&&>;
+
+    // Generator<Ref, Val> modeled after std::generator (C++23)
+    // - yielded objects are never copied into the promise, only their address is stored
+    // - co_yield elements_of(nested_generator) resumes the innermost generator directly - O(1) instead of O(depth)
+    template <typename Ref, typename Val = void>
+    class [[nodiscard]] Generator : public std::ranges::view_interface<Generator<Ref, Val>>
+    {
+        using value = std::conditional_t<std::is_void_v<Val>, std::remove_cvref_t<Ref>, Val>;
+        using reference = std::conditional_t<std::is_void_v<Val>, Ref&&, Ref>;
+        using yielded = std::conditional_t<std::is_reference_v<reference>, reference, const reference&>;
+
+    public:
+        struct promise_type;
+
+        using CoroutineHandle = std::coroutine_handle<promise_type>;
+
+        struct promise_type : Coroutines::PooledPromise
+        {
+            Generator get_return_object() noexcept
+            {
+                return Generator{CoroutineHandle::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept { return instrumented(std::suspend_always{}); }
+
+            auto final_suspend() noexcept
+            {
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept { return false; }
+
+                    std::coroutine_handle<> await_suspend(CoroutineHandle finished) noexcept
+                    {
+                        auto& promise = finished.promise();
+
+                        if (!promise.parent_)
+                            return std::noop_coroutine();
+
+                        // nested generator is done - continue the parent
+                        promise.root_->active_ = promise.parent_;
+                        return promise.parent_;
+                    }
+
+                    void await_resume() const noexcept { }
+                };
+
+                return instrumented(FinalAwaiter{});
+            }
+
+            auto yield_value(yielded yielded_value) noexcept
+            {
+                root_->value_ = std::addressof(yielded_value);
+                return instrumented(std::suspend_always{});
+            }
+
+            // lvalue yielded for rvalue reference - a copy is kept in the awaiter (inside the coroutine frame)
+            auto yield_value(const std::remove_reference_t<yielded>& lvalue)
+                requires std::is_rvalue_reference_v<yielded>
+                && std::constructible_from<std::remove_cvref_t<yielded>, const std::remove_reference_t<yielded>&>
+            {
+                struct CopyAwaiter
+                {
+                    std::remove_cvref_t<yielded> copy;
+                    promise_type* root;
+
+                    bool await_ready() const noexcept { return false; }
+
+                    void await_suspend(std::coroutine_handle<>) noexcept
+                    {
+                        root->value_ = std::addressof(copy);
+                    }
+
+                    void await_resume() const noexcept { }
+                };
+
+                return instrumented(CopyAwaiter{lvalue, root_});
+            }
+
+            auto yield_value(elements_of<Generator&&> nested) noexcept
+            {
+                return instrumented(NestedAwaiter{std::move(nested.range)});
+            }
+
+            // any other range is yielded through a nested helper generator
+            template <std::ranges::input_range TRange>
+                requires std::convertible_to<std::ranges::range_reference_t<TRange>, yielded>
+                || std::constructible_from<std::remove_cvref_t<yielded>, std::ranges::range_reference_t<TRange>>
+            auto yield_value(elements_of<TRange> nested)
+            {
+                auto yield_all = [](std::ranges::iterator_t<TRange> first, std::ranges::sentinel_t<TRange> last) -> Generator {
+                    for (; first != last; ++first)
+                    {
+                        if constexpr (std::convertible_to<std::ranges::range_reference_t<TRange>, yielded>)
+                            co_yield static_cast<yielded>(*first);
+                        else
+                            co_yield std::remove_cvref_t<yielded>(*first); // e.g. int& for int&& - yields a temporary copy
+                    }
+                };
+
+                return instrumented(NestedAwaiter{yield_all(std::ranges::begin(nested.range), std::ranges::end(nested.range))});
+            }
+
+            void return_void() const noexcept { }
+
+            void unhandled_exception()
+            {
+                if (!parent_)
+                    throw; // root - propagates to the consumer resuming the generator
+
+                exception_ = std::current_exception(); // rethrown in parent by NestedAwaiter
+            }
+
+            template <typename T>
+            void await_transform(T&&) = delete;
+
+        private:
+            friend class Generator;
+
+            std::add_pointer_t<yielded> value_ = nullptr;
+            promise_type* root_ = this;
+            CoroutineHandle active_ = CoroutineHandle::from_promise(*this); // innermost running generator (valid in root)
+            CoroutineHandle parent_ = nullptr;
+            std::exception_ptr exception_;
+
+            struct NestedAwaiter
+            {
+                Generator nested;
+
+                bool await_ready() const noexcept { return !nested.coroutine_hndl_; }
+
+                std::coroutine_handle<> await_suspend(CoroutineHandle current) noexcept
+                {
+                    auto& current_promise = current.promise();
+                    auto& nested_promise = nested.coroutine_hndl_.promise();
+
+                    nested_promise.root_ = current_promise.root_;
+                    nested_promise.parent_ = current;
+                    current_promise.root_->active_ = nested.coroutine_hndl_;
+
+                    return nested.coroutine_hndl_;
+                }
+
+                void await_resume()
+                {
+                    if (nested.coroutine_hndl_ && nested.coroutine_hndl_.promise().exception_)
+                        std::rethrow_exception(std::move(nested.coroutine_hndl_.promise().exception_));
+                }
+            };
+        };
+
+        class iterator
+        {
+        public:
+            using value_type = value;
+            using difference_type = std::ptrdiff_t;
+
+            iterator(iterator&& other) noexcept
+                : coroutine_hndl_{std::exchange(other.coroutine_hndl_, nullptr)}
+            { }
+
+            iterator& operator=(iterator&& other) noexcept
+            {
+                coroutine_hndl_ = std::exchange(other.coroutine_hndl_, nullptr);
+                return *this;
+            }
+
+            reference operator*() const noexcept(std::is_nothrow_copy_constructible_v<reference>)
+            {
+                assert(coroutine_hndl_ && !coroutine_hndl_.done());
+                return static_cast<reference>(*coroutine_hndl_.promise().value_);
+            }
+
+            iterator& operator++()
+            {
+                assert(coroutine_hndl_ && !coroutine_hndl_.done());
+                coroutine_hndl_.promise().active_.resume();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+            {
+                return it.coroutine_hndl_.done();
+            }
+
+        private:
+            friend class Generator;
+
+            explicit iterator(CoroutineHandle coroutine_hndl) noexcept
+                : coroutine_hndl_{coroutine_hndl}
+            { }
+
+            CoroutineHandle coroutine_hndl_;
+        };
+
+        Generator(const Generator&) = delete;
+        Generator& operator=(const Generator&) = delete;
+
+        Generator(Generator&& other) noexcept
+            : coroutine_hndl_{std::exchange(other.coroutine_hndl_, nullptr)}
+        { }
+
+        Generator& operator=(Generator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (coroutine_hndl_)
+                    coroutine_hndl_.destroy();
+                coroutine_hndl_ = std::exchange(other.coroutine_hndl_, nullptr);
+            }
+            return *this;
+        }
+
+        ~Generator()
+        {
+            if (coroutine_hndl_)
+                coroutine_hndl_.destroy();
+        }
+
+        // may be called only once, before any call to next_value()
+        iterator begin()
+        {
+            assert(coroutine_hndl_);
+            coroutine_hndl_.promise().active_.resume();
+            return iterator{coroutine_hndl_};
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+
+        std::optional<value> next_value()
+        {
+            assert(coroutine_hndl_);
+
+            if (coroutine_hndl_.done())
+                return std::nullopt;
+
+            coroutine_hndl_.promise().active_.resume();
+
+            if (coroutine_hndl_.done())
+                return std::nullopt;
+
+            return static_cast<reference>(*coroutine_hndl_.promise().value_);
+        }
+
+    private:
+        explicit Generator(CoroutineHandle coroutine_hndl) noexcept
+            : coroutine_hndl_{coroutine_hndl}
+        { }
+
+        CoroutineHandle coroutine_hndl_ = nullptr;
+    };
+} // namespace FutureStd
+
+#endif
@@ -0,0 +1,108 @@
+#include "instrumentation.hpp"
+#include "generator.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+
+using Coroutines::LatencyHistogram;
+using Coroutines::Task;
+
+TEST_CASE("LatencyHistogram - buckets")
+{
+    for (std::uint64_t value : {0ull, 1ull, 63ull, 64ull, 65ull, 1000ull, 123'456'789ull, ~0ull})
+    {
+        const auto index = LatencyHistogram::bucket_index(value);
+        CHECK(LatencyHistogram::bucket_upper_bound(index) >= value);
+        if (index > 0)
+            CHECK(LatencyHistogram::bucket_upper_bound(index - 1) < value);
+    }
+
+    // relative error of a bucket is below 1 / sub_bucket_count
+    const auto index = LatencyHistogram::bucket_index(1'000'000);
+    CHECK(LatencyHistogram::bucket_upper_bound(index) - LatencyHistogram::bucket_upper_bound(index - 1) <= 1'000'000 / LatencyHistogram::sub_bucket_count);
+}
+
+TEST_CASE("LatencyHistogram - percentiles")
+{
+    LatencyHistogram histogram;
+
+    for (std::uint64_t value = 1; value <= 10'000; ++value)
+        histogram.record(value);
+
+    CHECK(histogram.count() == 10'000);
+    CHECK(histogram.max() == 10'000);
+    CHECK(histogram.mean() == 5000.5);
+    CHECK(histogram.value_at_percentile(0) == 1);
+    CHECK(histogram.value_at_percentile(100) == 10'000);
+
+    const auto median = histogram.value_at_percentile(50);
+    CHECK(median >= 5'000);
+    CHECK(median <= 5'000 + 5'000 / LatencyHistogram::sub_bucket_count);
+
+    std::ostringstream out;
+    histogram.write_percentile_distribution(out);
+    CHECK(out.str().find("#[Total count    =        10000]") != std::string::npos);
+}
+
+#ifdef COROUTINES_INSTRUMENTATION
+
+namespace
+{
+    Task<int> instrumented_leaf(helpers::ThreadPool& pool, int value)
+    {
+        co_await Coroutines::schedule_on(pool);
+        co_return value;
+    }
+
+    Task<int> instrumented_root(helpers::ThreadPool& pool)
+    {
+        int sum = 0;
+        for (int i = 1; i <= 10; ++i)
+            sum += co_await instrumented_leaf(pool, i);
+        co_return sum;
+    }
+
+    FutureStd::Generator<int> instrumented_counter(int n)
+    {
+        for (int i = 0; i < n; ++i)
+            co_yield i;
+    }
+}
+
+TEST_CASE("instrumentation - per coroutine function statistics")
+{
+    auto& registry = Coroutines::CoroutineRegistry::instance();
+
+    helpers::ThreadPool pool{2};
+    CHECK(Coroutines::sync_wait(instrumented_root(pool)) == 55);
+
+    const auto* leaf = registry.find("instrumented_leaf");
+    REQUIRE(leaf != nullptr);
+    CHECK(leaf->frames == 10);
+    CHECK(leaf->frame_size > 0);
+    CHECK(leaf->resumes == 20); // started + resumed on the pool
+    CHECK(leaf->suspension_latency.count() == 20);
+
+    const auto* root = registry.find("instrumented_root");
+    REQUIRE(root != nullptr);
+    CHECK(root->frames == 1);
+    CHECK(root->resumes == 11); // started + resumed by every leaf
+
+    int sum = 0;
+    for (int i : instrumented_counter(5))
+        sum += i;
+    CHECK(sum == 10);
+
+    const auto* counter = registry.find("instrumented_counter");
+    REQUIRE(counter != nullptr);
+    CHECK(counter->resumes == 6);
+
+    std::ostringstream report;
+    registry.write_report(report);
+    CHECK(report.str().find("instrumented_leaf") != std::string::npos);
+}
+
+#endif
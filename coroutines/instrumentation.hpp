@@ -0,0 +1,334 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include "awaitable_traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Coroutines
+{
+    // HDR-style log-linear histogram of non-negative values (e.g. nanoseconds)
+    // - values are grouped by magnitude (power of two), each magnitude is split into sub_bucket_count linear buckets,
+    //   so the relative error of a reported value is below 1 / sub_bucket_count
+    // - recording is wait-free (relaxed atomic increments) - may be shared by many threads
+    class LatencyHistogram
+    {
+    public:
+        static constexpr unsigned sub_bucket_bits = 5;
+        static constexpr std::uint64_t sub_bucket_count = std::uint64_t{1} << sub_bucket_bits;
+
+        static constexpr std::size_t bucket_index(std::uint64_t value) noexcept
+        {
+            if (value < 2 * sub_bucket_count)
+                return static_cast<std::size_t>(value);
+
+            const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - sub_bucket_bits;
+            return static_cast<std::size_t>(shift * sub_bucket_count + (value >> shift));
+        }
+
+        // the largest value that falls into the bucket
+        static constexpr std::uint64_t bucket_upper_bound(std::size_t index) noexcept
+        {
+            if (index < 2 * sub_bucket_count)
+                return index;
+
+            const unsigned shift = static_cast<unsigned>(index / sub_bucket_count) - 1;
+            const std::uint64_t sub_bucket = index % sub_bucket_count + sub_bucket_count;
+            return ((sub_bucket + 1) << shift) - 1;
+        }
+
+        static constexpr std::size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+        void record(std::uint64_t value) noexcept
+        {
+            buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+            count_.fetch_add(1, std::memory_order_relaxed);
+            sum_.fetch_add(value, std::memory_order_relaxed);
+
+            auto max = max_.load(std::memory_order_relaxed);
+            while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+            { }
+        }
+
+        void record(std::chrono::nanoseconds duration) noexcept
+        {
+            record(static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0)));
+        }
+
+        std::uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+        std::uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+
+        double mean() const noexcept
+        {
+            const auto n = count();
+            return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+        }
+
+        // smallest recorded value v such that at least `percentile` % of values are <= v (within the bucket precision)
+        std::uint64_t value_at_percentile(double percentile) const noexcept
+        {
+            const auto n = count();
+            if (n == 0)
+                return 0;
+
+            const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(n) + 0.5));
+
+            std::uint64_t cumulative = 0;
+            for (std::size_t index = 0; index < bucket_count; ++index)
+            {
+                cumulative += buckets_[index].load(std::memory_order_relaxed);
+                if (cumulative >= rank)
+                    return std::min(bucket_upper_bound(index), max());
+            }
+
+            return max();
+        }
+
+        // text export in the layout of HdrHistogram's outputPercentileDistribution
+        void write_percentile_distribution(std::ostream& out, double value_unit_ratio = 1000.0) const
+        {
+            const auto n = count();
+            out << std::setw(12) << "Value" << " " << std::setw(14) << "Percentile" << " " << std::setw(10) << "TotalCount" << " " << std::setw(14) << "1/(1-Percentile)" << "\n\n";
+
+            std::uint64_t cumulative = 0;
+            for (std::size_t index = 0; index < bucket_count && cumulative < n; ++index)
+            {
+                const auto in_bucket = buckets_[index].load(std::memory_order_relaxed);
+                if (in_bucket == 0)
+                    continue;
+
+                cumulative += in_bucket;
+                const double fraction = static_cast<double>(cumulative) / static_cast<double>(n);
+                const auto value = static_cast<double>(std::min(bucket_upper_bound(index), max())) / value_unit_ratio;
+
+                out << std::fixed << std::setprecision(3) << std::setw(12) << value << " "
+                    << std::setprecision(12) << std::setw(14) << fraction << " "
+                    << std::setw(10) << cumulative << " ";
+                if (cumulative < n)
+                    out << std::setprecision(2) << std::setw(14) << 1.0 / (1.0 - fraction);
+                out << "\n";
+            }
+
+            out << std::setprecision(3) << "#[Mean    = " << std::setw(12) << mean() / value_unit_ratio
+                << ", Max        = " << std::setw(12) << static_cast<double>(max()) / value_unit_ratio << "]\n"
+                << "#[Total count    = " << std::setw(12) << n << "]\n";
+        }
+
+    private:
+        std::array<std::atomic<std::uint64_t>, bucket_count> buckets_{};
+        std::atomic<std::uint64_t> count_ = 0;
+        std::atomic<std::uint64_t> sum_ = 0;
+        std::atomic<std::uint64_t> max_ = 0;
+    };
+
+    static_assert(LatencyHistogram::bucket_index(~std::uint64_t{0}) == LatencyHistogram::bucket_count - 1);
+
+    // statistics of all frames of a single coroutine function
+    struct CoroutineStats
+    {
+        std::string function;
+        std::string file;
+        std::uint_least32_t line = 0;
+
+        std::atomic<std::uint64_t> frames = 0;
+        std::atomic<std::uint64_t> frame_size = 0; // the same for every frame of a function
+        std::atomic<std::uint64_t> resumes = 0;
+        std::atomic<std::uint64_t> running_ns = 0;
+        std::atomic<std::uint64_t> suspended_ns = 0;
+        LatencyHistogram running_time;      // between resumption and the next suspension
+        LatencyHistogram suspension_latency; // between suspension and resumption
+    };
+
+    // process-wide registry of CoroutineStats keyed by the coroutine function
+    class CoroutineRegistry
+    {
+    public:
+        static CoroutineRegistry& instance()
+        {
+            static CoroutineRegistry registry;
+            return registry;
+        }
+
+        CoroutineStats& stats_for(const std::source_location& location)
+        {
+            thread_local std::unordered_map<const char*, CoroutineStats*> cache; // function_name() is a string literal
+
+            auto& cached = cache[location.function_name()];
+            if (!cached)
+                cached = &find_or_insert(location);
+            return *cached;
+        }
+
+        // first function whose signature contains the text - nullptr if none of its frames has been allocated yet
+        const CoroutineStats* find(std::string_view function_name) const
+        {
+            std::lock_guard lk{mtx_};
+
+            for (const auto& [key, stats] : stats_)
+            {
+                if (stats->function.find(function_name) != std::string::npos)
+                    return stats.get();
+            }
+            return nullptr;
+        }
+
+        std::vector<const CoroutineStats*> snapshot() const
+        {
+            std::lock_guard lk{mtx_};
+
+            std::vector<const CoroutineStats*> result;
+            for (const auto& [key, stats] : stats_)
+                result.push_back(stats.get());
+            return result;
+        }
+
+        void write_report(std::ostream& out) const
+        {
+            for (const CoroutineStats* stats : snapshot())
+            {
+                out << stats->function << " (" << stats->file << ":" << stats->line << ")\n"
+                    << "  frames: " << stats->frames << " x " << stats->frame_size << " B"
+                    << ", resumes: " << stats->resumes
+                    << ", running: " << stats->running_ns / 1000 << " us"
+                    << ", suspended: " << stats->suspended_ns / 1000 << " us\n"
+                    << "  suspension latency [us] - p50: " << stats->suspension_latency.value_at_percentile(50) / 1000.0
+                    << ", p99: " << stats->suspension_latency.value_at_percentile(99) / 1000.0
+                    << ", max: " << stats->suspension_latency.max() / 1000.0 << "\n";
+            }
+        }
+
+    private:
+        mutable std::mutex mtx_;
+        std::map<std::tuple<std::string, std::string, std::uint_least32_t>, std::unique_ptr<CoroutineStats>> stats_;
+
+        CoroutineStats& find_or_insert(const std::source_location& location)
+        {
+            std::lock_guard lk{mtx_};
+
+            auto& stats = stats_[{location.function_name(), location.file_name(), location.line()}];
+            if (!stats)
+            {
+                stats = std::make_unique<CoroutineStats>();
+                stats->function = location.function_name();
+                stats->file = location.file_name();
+                stats->line = location.line();
+            }
+            return *stats;
+        }
+    };
+
+    // per-frame bookkeeping embedded in PooledPromise when COROUTINES_INSTRUMENTATION is defined
+    class CoroutineProbe
+    {
+    public:
+        // set by the allocating operator new, taken over by the promise constructed right after it
+        static CoroutineStats*& pending_stats() noexcept
+        {
+            thread_local CoroutineStats* stats = nullptr;
+            return stats;
+        }
+
+        static void frame_allocated(CoroutineStats& stats, std::size_t frame_size) noexcept
+        {
+            stats.frames.fetch_add(1, std::memory_order_relaxed);
+            stats.frame_size.store(frame_size, std::memory_order_relaxed);
+            pending_stats() = &stats;
+        }
+
+        CoroutineProbe() noexcept
+            : stats_{std::exchange(pending_stats(), nullptr)} // stays null for frames allocated with a custom allocator
+            , last_transition_{now()}
+        { }
+
+        CoroutineProbe(const CoroutineProbe&) = delete;
+        CoroutineProbe& operator=(const CoroutineProbe&) = delete;
+
+        void suspended() noexcept
+        {
+            if (!stats_)
+                return;
+
+            const auto running = transition();
+            stats_->running_ns.fetch_add(running, std::memory_order_relaxed);
+            stats_->running_time.record(running);
+        }
+
+        void resumed() noexcept
+        {
+            if (!stats_)
+                return;
+
+            const auto suspended = transition();
+            stats_->resumes.fetch_add(1, std::memory_order_relaxed);
+            stats_->suspended_ns.fetch_add(suspended, std::memory_order_relaxed);
+            stats_->suspension_latency.record(suspended);
+        }
+
+    private:
+        CoroutineStats* stats_;
+        std::uint64_t last_transition_;
+
+        static std::uint64_t now() noexcept
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        std::uint64_t transition() noexcept
+        {
+            const auto time = now();
+            return time - std::exchange(last_transition_, time);
+        }
+    };
+
+    // reports suspension and resumption of the awaiting coroutine to its probe
+    template <typename TAwaiter>
+    struct InstrumentedAwaiter
+    {
+        CoroutineProbe& probe;
+        TAwaiter awaiter;
+        bool suspended = false;
+
+        bool await_ready() noexcept(noexcept(awaiter.await_ready()))
+        {
+            return awaiter.await_ready();
+        }
+
+        template <typename TPromise>
+        auto await_suspend(std::coroutine_handle<TPromise> awaiting) noexcept(noexcept(awaiter.await_suspend(awaiting)))
+            -> decltype(awaiter.await_suspend(awaiting))
+        {
+            // before the inner await_suspend - afterwards the coroutine may already run (or be destroyed) on another thread
+            suspended = true;
+            probe.suspended();
+            return awaiter.await_suspend(awaiting);
+        }
+
+        decltype(auto) await_resume() noexcept(noexcept(awaiter.await_resume()))
+        {
+            if (suspended)
+                probe.resumed();
+            return awaiter.await_resume();
+        }
+    };
+} // namespace Coroutines
+
+#endif
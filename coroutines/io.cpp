@@ -0,0 +1,123 @@
+#include "io_backends.hpp"
+#include "io_context.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using Coroutines::IoContext;
+using Coroutines::Task;
+
+namespace
+{
+    std::string temp_file_path(const std::string& name)
+    {
+        return (std::filesystem::temp_directory_path() / (name + "-" + std::to_string(::getpid()))).string();
+    }
+}
+
+Task<std::string> write_and_read_back(IoContext& io, std::string path, std::string text)
+{
+    const int fd = co_await io.async_open(path, O_RDWR | O_CREAT | O_TRUNC);
+
+    const auto written = co_await io.async_write(fd, std::as_bytes(std::span{text}), 0);
+    REQUIRE(written == text.size());
+
+    std::string content(text.size(), '\0');
+    const auto read = co_await io.async_read(fd, std::as_writable_bytes(std::span{content}), 0);
+    content.resize(read);
+
+    co_await io.async_close(fd);
+
+    co_return content;
+}
+
+TEST_CASE("io context - open, write, read, close")
+{
+    for (auto backend : available_backends())
+    {
+        IoContext io{backend};
+        REQUIRE(io.backend() == backend);
+
+        const auto path = temp_file_path("io-context-test");
+        const auto text = "Hello from coroutine I/O\n"s;
+
+        CHECK(io.run(write_and_read_back(io, path, text)) == text);
+
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("io context - errors are thrown from co_await")
+{
+    for (auto backend : available_backends())
+    {
+        IoContext io{backend};
+
+        auto open_missing = [](IoContext& io) -> Task<int> {
+            co_return co_await io.async_open("/this/path/does/not/exist", O_RDONLY);
+        };
+
+        try
+        {
+            io.run(open_missing(io));
+            FAIL("exception expected");
+        }
+        catch (const std::system_error& e)
+        {
+            CHECK(e.code() == std::errc::no_such_file_or_directory);
+        }
+    }
+}
+
+TEST_CASE("io context - operations started on other threads complete on the loop thread")
+{
+    helpers::ThreadPool pool{2};
+
+    for (auto backend : available_backends())
+    {
+        IoContext io{backend};
+        const auto path = temp_file_path("io-context-remote");
+
+        auto task = [](IoContext& io, helpers::ThreadPool& pool, std::string path) -> Task<std::thread::id> {
+            co_await Coroutines::schedule_on(pool);
+
+            const int fd = co_await io.async_open(path, O_RDWR | O_CREAT | O_TRUNC);
+            co_await io.async_close(fd);
+
+            co_return std::this_thread::get_id();
+        };
+
+        CHECK(io.run(task(io, pool, path)) == std::this_thread::get_id());
+
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("io context - destroyed right after run completed on another thread")
+{
+    helpers::ThreadPool pool{2};
+
+    auto on_pool = [](helpers::ThreadPool& pool) -> Task<int> {
+        co_await Coroutines::schedule_on(pool);
+        co_return 7;
+    };
+
+    for (auto backend : available_backends())
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            auto io = std::make_unique<IoContext>(backend);
+            CHECK(io->run(on_pool(pool)) == 7);
+            io.reset(); // the pool thread may still be handing the completion over
+        }
+    }
+}
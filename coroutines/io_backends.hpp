@@ -0,0 +1,27 @@
+#ifndef IO_BACKENDS_HPP
+#define IO_BACKENDS_HPP
+
+#include "io_context.hpp"
+
+#include <system_error>
+#include <vector>
+
+// backends of IoContext supported by the machine running the tests
+inline std::vector<Coroutines::IoContext::Backend> available_backends()
+{
+    std::vector backends = {Coroutines::IoContext::Backend::thread_pool};
+
+    try
+    {
+        Coroutines::IoContext io{Coroutines::IoContext::Backend::io_uring};
+        backends.push_back(Coroutines::IoContext::Backend::io_uring);
+    }
+    catch (const std::system_error&)
+    {
+        // kernel without io_uring - only the fallback is tested
+    }
+
+    return backends;
+}
+
+#endif
@@ -0,0 +1,878 @@
+#ifndef IO_CONTEXT_HPP
+#define IO_CONTEXT_HPP
+
+#include "task.hpp"
+#include "thread_pool.hpp"
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <poll.h>
+#include <span>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace Coroutines
+{
+    namespace detail
+    {
+        [[noreturn]] inline void throw_errno(int error, const char* what)
+        {
+            throw std::system_error(error, std::generic_category(), what);
+        }
+
+        // state of a single I/O operation - lives in the awaiter (inside the suspended coroutine frame)
+        struct IoOperation
+        {
+            enum class Code
+            {
+                resume,
+                open,
+                read,
+                write,
+                close,
+                sleep
+            };
+
+            Code code;
+            int fd = -1;
+            const char* path = nullptr;
+            int flags = 0;
+            mode_t mode = 0;
+            void* buffer = nullptr;
+            std::size_t size = 0;
+            std::uint64_t offset = 0;
+            TimerWheel::Timer* timer = nullptr;
+            TimerWheel::Tick deadline = 0;
+
+            std::coroutine_handle<> awaiting = nullptr;
+            int result = 0;
+            bool completed = false;
+
+            // blocking equivalent - used by the thread-pool backend
+            int perform() const noexcept
+            {
+                ssize_t result = 0;
+                switch (code)
+                {
+                case Code::open:
+                    result = ::openat(AT_FDCWD, path, flags, mode);
+                    break;
+                case Code::read:
+                    result = ::pread(fd, buffer, size, static_cast<off_t>(offset));
+                    break;
+                case Code::write:
+                    result = ::pwrite(fd, buffer, size, static_cast<off_t>(offset));
+                    break;
+                case Code::close:
+                    result = ::close(fd);
+                    break;
+                case Code::resume:
+                case Code::sleep:
+                    break;
+                }
+
+                return result < 0 ? -errno : static_cast<int>(result);
+            }
+        };
+
+        // minimal io_uring wrapper on raw syscalls (no liburing)
+        class IoUring
+        {
+        public:
+            static std::unique_ptr<IoUring> try_create(unsigned entries)
+            {
+                io_uring_params params{};
+                const int ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if (ring_fd < 0)
+                    return nullptr;
+
+                std::unique_ptr<IoUring> ring{new IoUring{ring_fd, params}};
+                if (!ring->map_rings() || !ring->supports_required_ops())
+                    return nullptr;
+
+                return ring;
+            }
+
+            IoUring(const IoUring&) = delete;
+            IoUring& operator=(const IoUring&) = delete;
+
+            ~IoUring()
+            {
+                if (sqes_ != MAP_FAILED)
+                    ::munmap(sqes_, params_.sq_entries * sizeof(io_uring_sqe));
+                if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+                    ::munmap(cq_ring_, cq_ring_size_);
+                if (sq_ring_ != MAP_FAILED)
+                    ::munmap(sq_ring_, sq_ring_size_);
+                ::close(ring_fd_);
+            }
+
+            // returns nullptr when the submission queue is full
+            io_uring_sqe* next_sqe() noexcept
+            {
+                const unsigned head = std::atomic_ref{*sq_head_}.load(std::memory_order_acquire);
+                const unsigned tail = *sq_tail_ + unsubmitted_;
+
+                if (tail - head == params_.sq_entries)
+                    return nullptr;
+
+                const unsigned index = tail & *sq_mask_;
+                sq_array_[index] = index;
+                ++unsubmitted_;
+
+                io_uring_sqe* sqe = &sqes_[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                return sqe;
+            }
+
+            // submits prepared entries and optionally waits for at least one completion
+            void submit(bool wait_for_completion)
+            {
+                std::atomic_ref{*sq_tail_}.store(*sq_tail_ + unsubmitted_, std::memory_order_release);
+
+                const unsigned to_submit = std::exchange(unsubmitted_, 0);
+                const unsigned flags = wait_for_completion ? IORING_ENTER_GETEVENTS : 0;
+
+                if (to_submit == 0 && !wait_for_completion)
+                    return;
+
+                while (::syscall(__NR_io_uring_enter, ring_fd_, to_submit, wait_for_completion ? 1 : 0, flags, nullptr, 0) < 0)
+                {
+                    if (errno != EINTR)
+                        throw_errno(errno, "io_uring_enter");
+                }
+            }
+
+            template <typename TFunction>
+            std::size_t for_each_completion(TFunction&& on_completion)
+            {
+                std::size_t count = 0;
+                unsigned head = *cq_head_;
+
+                while (head != std::atomic_ref{*cq_tail_}.load(std::memory_order_acquire))
+                {
+                    const io_uring_cqe cqe = cqes_[head & *cq_mask_];
+                    std::atomic_ref{*cq_head_}.store(++head, std::memory_order_release); // slot can be reused from now on
+
+                    on_completion(cqe.user_data, cqe.res);
+                    ++count;
+                }
+
+                return count;
+            }
+
+        private:
+            int ring_fd_;
+            io_uring_params params_;
+
+            void* sq_ring_ = MAP_FAILED;
+            void* cq_ring_ = MAP_FAILED;
+            io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+            std::size_t sq_ring_size_ = 0;
+            std::size_t cq_ring_size_ = 0;
+
+            unsigned* sq_head_ = nullptr;
+            unsigned* sq_tail_ = nullptr;
+            unsigned* sq_mask_ = nullptr;
+            unsigned* sq_array_ = nullptr;
+            unsigned* cq_head_ = nullptr;
+            unsigned* cq_tail_ = nullptr;
+            unsigned* cq_mask_ = nullptr;
+            io_uring_cqe* cqes_ = nullptr;
+
+            unsigned unsubmitted_ = 0;
+
+            IoUring(int ring_fd, const io_uring_params& params)
+                : ring_fd_{ring_fd}
+                , params_{params}
+            { }
+
+            bool map_rings()
+            {
+                sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+                cq_ring_size_ = params_.cq_off.cqes + params_.cq_entries * sizeof(io_uring_cqe);
+
+                const bool single_mmap = params_.features & IORING_FEAT_SINGLE_MMAP;
+                if (single_mmap)
+                    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+                sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+                if (sq_ring_ == MAP_FAILED)
+                    return false;
+
+                cq_ring_ = single_mmap ? sq_ring_ : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+                if (cq_ring_ == MAP_FAILED)
+                    return false;
+
+                sqes_ = static_cast<io_uring_sqe*>(::mmap(nullptr, params_.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+                if (sqes_ == MAP_FAILED)
+                    return false;
+
+                auto* sq = static_cast<std::byte*>(sq_ring_);
+                sq_head_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.head);
+                sq_tail_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.tail);
+                sq_mask_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.ring_mask);
+                sq_array_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.array);
+
+                auto* cq = static_cast<std::byte*>(cq_ring_);
+                cq_head_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.head);
+                cq_tail_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.tail);
+                cq_mask_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params_.cq_off.cqes);
+
+                return true;
+            }
+
+            bool supports_required_ops() const
+            {
+                constexpr unsigned probe_ops = 64;
+                std::vector<std::byte> storage(sizeof(io_uring_probe) + probe_ops * sizeof(io_uring_probe_op));
+                auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+
+                if (::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe, probe_ops) < 0)
+                    return false;
+
+                for (unsigned op : {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE})
+                {
+                    if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+                        return false;
+                }
+
+                return true;
+            }
+        };
+    } // namespace detail
+
+    // event loop completing asynchronous file operations and timers
+    // - io_uring is used when the kernel supports it, otherwise blocking calls are run on a thread pool
+    // - awaiting coroutines are resumed on the thread driving the loop (run/run_one);
+    //   operations started on other threads are handed over to the loop
+    // - timers are kept in a TimerWheel with 1 ms ticks
+    class IoContext
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Backend
+        {
+            automatic,
+            io_uring,
+            thread_pool
+        };
+
+        explicit IoContext(Backend backend = Backend::automatic, unsigned queue_depth = 256)
+            : wake_fd_{::eventfd(0, EFD_CLOEXEC)}
+        {
+            if (wake_fd_ < 0)
+                detail::throw_errno(errno, "eventfd");
+
+            if (backend != Backend::thread_pool)
+                ring_ = detail::IoUring::try_create(queue_depth);
+
+            if (!ring_)
+            {
+                if (backend == Backend::io_uring)
+                {
+                    ::close(wake_fd_);
+                    throw std::system_error(std::make_error_code(std::errc::function_not_supported), "io_uring");
+                }
+
+                fallback_pool_ = std::make_unique<helpers::ThreadPool>();
+            }
+        }
+
+        IoContext(const IoContext&) = delete;
+        IoContext& operator=(const IoContext&) = delete;
+
+        // waits until the tasks which lost a with_timeout race complete - they may still use the context
+        ~IoContext()
+        {
+            remote_waiting_ = true; // such a task may be finishing on another thread
+            while (has_detached_tasks())
+                run_one();
+
+            fallback_pool_.reset(); // joins workers before the wake-up eventfd is closed
+            ring_.reset();
+            ::close(wake_fd_);
+        }
+
+        Backend backend() const noexcept
+        {
+            return ring_ ? Backend::io_uring : Backend::thread_pool;
+        }
+
+        // awaitables - results are checked in await_resume, errors are thrown as std::system_error
+        // - reads and writes may transfer less than the buffer size (as read/write do), the number of bytes is returned
+        auto async_open(std::string path, int flags, mode_t mode = 0644)
+        {
+            return OpenAwaiter{*this, std::move(path), flags, mode};
+        }
+
+        auto async_read(int fd, std::span<std::byte> buffer, std::uint64_t offset)
+        {
+            detail::IoOperation operation{.code = detail::IoOperation::Code::read, .fd = fd, .buffer = buffer.data(), .size = buffer.size(), .offset = offset};
+            return IoAwaiter<std::size_t>{*this, operation, "async_read"};
+        }
+
+        auto async_write(int fd, std::span<const std::byte> buffer, std::uint64_t offset)
+        {
+            detail::IoOperation operation{.code = detail::IoOperation::Code::write, .fd = fd, .buffer = const_cast<std::byte*>(buffer.data()), .size = buffer.size(), .offset = offset};
+            return IoAwaiter<std::size_t>{*this, operation, "async_write"};
+        }
+
+        auto async_close(int fd)
+        {
+            return IoAwaiter<void>{*this, detail::IoOperation{.code = detail::IoOperation::Code::close, .fd = fd}, "async_close"};
+        }
+
+        // co_await io.schedule() - continues the coroutine on the thread running the loop
+        auto schedule()
+        {
+            return IoAwaiter<void>{*this, detail::IoOperation{.code = detail::IoOperation::Code::resume}, "schedule"};
+        }
+
+        // the coroutine is resumed on the loop thread, never before the deadline
+        // - the awaiting coroutine must not be destroyed while it sleeps
+        auto sleep_until(Clock::time_point deadline)
+        {
+            return SleepAwaiter{*this, to_tick(deadline)};
+        }
+
+        auto sleep_for(Clock::duration duration)
+        {
+            return sleep_until(Clock::now() + duration);
+        }
+
+        // co_await io.with_timeout(task, duration) - std::optional<T> (bool for Task<void>), empty when the timeout expired first
+        // - the awaiting coroutine is resumed on the loop thread
+        // - a task that loses the race keeps running in the background and its result is dropped,
+        //   the context is not destroyed before it completes
+        template <typename T>
+        auto with_timeout(Task<T> task, Clock::duration timeout)
+        {
+            return TimeoutAwaiter<T>{std::move(task), std::make_shared<TimeoutState<T>>(*this, to_tick(Clock::now() + timeout))};
+        }
+
+        std::size_t pending_timers() const noexcept
+        {
+            return timers_.size();
+        }
+
+        // processes at least one event (blocks if nothing is ready) - returns false if there was nothing to wait for
+        bool run_one()
+        {
+            loop_thread_ = std::this_thread::get_id();
+
+            std::size_t processed = drain_remote_queue() + fire_timers();
+            const bool wait = processed == 0 && (in_flight_ > 0 || remote_waiting_ || !timers_.empty());
+
+            if (ring_)
+            {
+                arm_wake_up();
+                if (wait)
+                    arm_timeout();
+
+                ring_->submit(wait);
+                processed += ring_->for_each_completion([this](std::uint64_t user_data, int result) {
+                    if (user_data == wake_up_tag)
+                    {
+                        wake_up_armed_ = false;
+                        return;
+                    }
+
+                    if (user_data == timeout_tag)
+                    {
+                        --timeouts_in_flight_;
+                        return;
+                    }
+
+                    auto* operation = reinterpret_cast<detail::IoOperation*>(user_data);
+                    --in_flight_;
+                    operation->result = result;
+                    operation->completed = true;
+                    operation->awaiting.resume();
+                });
+            }
+            else if (wait)
+            {
+                pollfd wake_up{.fd = wake_fd_, .events = POLLIN, .revents = 0};
+                if (::poll(&wake_up, 1, milliseconds_to_next_timer()) > 0)
+                {
+                    std::uint64_t counter;
+                    [[maybe_unused]] auto read = ::read(wake_fd_, &counter, sizeof(counter));
+                }
+                processed += drain_remote_queue();
+            }
+
+            processed += fire_timers();
+
+            return processed > 0 || in_flight_ > 0 || !timers_.empty();
+        }
+
+        // drives the loop until the task completes
+        template <typename T>
+        T run(Task<T> task)
+        {
+            loop_thread_ = std::this_thread::get_id();
+
+            bool done = false; // guarded by remote_mtx_
+            std::conditional_t<std::is_void_v<T>, std::monostate, std::optional<T>> result;
+            std::exception_ptr exception;
+
+            [](IoContext& io, Task<T> task, bool& done, auto& result, std::exception_ptr& exception) -> detail::DetachedCoroutine {
+                try
+                {
+                    if constexpr (std::is_void_v<T>)
+                        co_await std::move(task);
+                    else
+                        result.emplace(co_await std::move(task));
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+
+                io.complete_run(done); // the last use of the context
+            }(*this, std::move(task), done, result, exception);
+
+            remote_waiting_ = true;
+            while (!is_run_completed(done))
+                run_one();
+            remote_waiting_ = false;
+
+            if (exception)
+                std::rethrow_exception(exception);
+
+            if constexpr (!std::is_void_v<T>)
+                return std::move(*result);
+        }
+
+    private:
+        static constexpr std::uint64_t wake_up_tag = 0;
+        static constexpr std::uint64_t timeout_tag = 1;
+
+        template <typename TResult>
+        struct IoAwaiter
+        {
+            IoContext& io;
+            detail::IoOperation operation;
+            const char* what;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> awaiting)
+            {
+                operation.awaiting = awaiting;
+                io.start(operation);
+            }
+
+            TResult await_resume() const
+            {
+                if (operation.result < 0)
+                    detail::throw_errno(-operation.result, what);
+
+                if constexpr (!std::is_void_v<TResult>)
+                    return static_cast<TResult>(operation.result);
+            }
+        };
+
+        struct OpenAwaiter : IoAwaiter<int>
+        {
+            std::string path;
+
+            OpenAwaiter(IoContext& io, std::string path, int flags, mode_t mode)
+                : IoAwaiter<int>{io, detail::IoOperation{.code = detail::IoOperation::Code::open, .flags = flags | O_CLOEXEC, .mode = mode}, "async_open"}
+                , path{std::move(path)}
+            { }
+
+            void await_suspend(std::coroutine_handle<> awaiting)
+            {
+                operation.path = path.c_str();
+                IoAwaiter<int>::await_suspend(awaiting);
+            }
+        };
+
+        struct SleepAwaiter : TimerWheel::Timer
+        {
+            IoContext& io;
+            detail::IoOperation operation;
+
+            SleepAwaiter(IoContext& io, TimerWheel::Tick deadline)
+                : TimerWheel::Timer{[](TimerWheel::Timer& timer) noexcept { static_cast<SleepAwaiter&>(timer).operation.awaiting.resume(); }}
+                , io{io}
+                , operation{.code = detail::IoOperation::Code::sleep, .timer = this, .deadline = deadline}
+            { }
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> awaiting)
+            {
+                operation.awaiting = awaiting;
+                io.start(operation);
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        template <typename T>
+        struct TimeoutState : TimerWheel::Timer
+        {
+            using Result = std::conditional_t<std::is_void_v<T>, bool, std::optional<T>>;
+
+            IoContext& io;
+            detail::IoOperation timer_operation;
+            detail::IoOperation resume_operation{.code = detail::IoOperation::Code::resume};
+            std::atomic<bool> finished = false; // claimed by whichever side completes first
+            Result result{};
+            std::exception_ptr exception;
+            std::shared_ptr<TimeoutState> timer_ref; // keeps the state alive while the timer is pending
+
+            TimeoutState(IoContext& io, TimerWheel::Tick deadline)
+                : TimerWheel::Timer{&on_timeout}
+                , io{io}
+                , timer_operation{.code = detail::IoOperation::Code::sleep, .timer = this, .deadline = deadline}
+            { }
+
+            static void on_timeout(TimerWheel::Timer& timer) noexcept
+            {
+                auto& state = static_cast<TimeoutState&>(timer);
+                auto keep_alive = std::move(state.timer_ref);
+
+                if (!state.finished.exchange(true))
+                    state.resume_operation.awaiting.resume();
+            }
+        };
+
+        template <typename T>
+        struct TimeoutAwaiter
+        {
+            Task<T> task;
+            std::shared_ptr<TimeoutState<T>> state;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> awaiting)
+            {
+                state->resume_operation.awaiting = awaiting;
+                state->timer_ref = state;
+                state->io.detached_task_started();
+                state->io.start(state->timer_operation);
+
+                run_until_finished(state, std::move(task)); // the awaiting coroutine may be resumed before this returns
+            }
+
+            typename TimeoutState<T>::Result await_resume()
+            {
+                if (state->is_scheduled()) // the task finished first
+                {
+                    state->io.timers_.cancel(*state);
+                    state->timer_ref.reset();
+                }
+
+                if (state->exception)
+                    std::rethrow_exception(state->exception);
+
+                return std::move(state->result);
+            }
+
+            static detail::DetachedCoroutine run_until_finished(std::shared_ptr<TimeoutState<T>> state, Task<T> task)
+            {
+                typename TimeoutState<T>::Result result{};
+                std::exception_ptr exception;
+
+                try
+                {
+                    if constexpr (std::is_void_v<T>)
+                    {
+                        co_await std::move(task);
+                        result = true;
+                    }
+                    else
+                        result.emplace(co_await std::move(task));
+                }
+                catch (...)
+                {
+                    exception = std::current_exception();
+                }
+
+                IoContext& io = state->io;
+
+                if (state->finished.exchange(true))
+                {
+                    io.detached_task_finished(); // timed out - the last use of the context
+                    co_return;
+                }
+
+                state->result = std::move(result);
+                state->exception = exception;
+
+                io.detached_task_finished(); // the awaiting coroutine keeps the context alive until it is resumed
+                io.start(state->resume_operation);
+            }
+        };
+
+        std::unique_ptr<detail::IoUring> ring_;
+        std::unique_ptr<helpers::ThreadPool> fallback_pool_;
+
+        int wake_fd_;
+        std::uint64_t wake_up_buffer_ = 0;
+        bool wake_up_armed_ = false;
+
+        std::atomic<std::thread::id> loop_thread_{};
+        TimerWheel timers_;
+        Clock::time_point start_time_ = Clock::now();
+        __kernel_timespec timeout_spec_{};
+        TimerWheel::Tick armed_timeout_ = 0;
+        unsigned timeouts_in_flight_ = 0;
+        std::size_t in_flight_ = 0;
+
+        std::mutex remote_mtx_;
+        std::vector<detail::IoOperation*> remote_queue_;
+        bool remote_waiting_ = false; // inside run() - work may still arrive from other threads
+        std::size_t detached_tasks_ = 0; // tasks started by with_timeout - guarded by remote_mtx_
+
+        bool on_loop_thread() const noexcept
+        {
+            return loop_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+        }
+
+        TimerWheel::Tick current_tick() const noexcept
+        {
+            return static_cast<TimerWheel::Tick>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_time_).count());
+        }
+
+        TimerWheel::Tick to_tick(Clock::time_point time_point) const noexcept
+        {
+            return static_cast<TimerWheel::Tick>(std::max<std::chrono::milliseconds::rep>(std::chrono::ceil<std::chrono::milliseconds>(time_point - start_time_).count(), 0));
+        }
+
+        std::size_t fire_timers()
+        {
+            return timers_.empty() ? 0 : timers_.advance(current_tick());
+        }
+
+        int milliseconds_to_next_timer() const noexcept
+        {
+            auto next = timers_.next_event();
+            if (!next)
+                return -1;
+
+            const auto now = current_tick();
+            return *next > now ? static_cast<int>(std::min<TimerWheel::Tick>(*next - now, std::numeric_limits<int>::max())) : 0;
+        }
+
+        // done is set together with the wake-up under the lock and run() reads it under the lock - run() cannot return
+        // (and the context cannot be destroyed) while the thread completing the task is still writing the wake-up
+        void complete_run(bool& done)
+        {
+            std::lock_guard lk{remote_mtx_};
+            done = true;
+
+            const std::uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+        }
+
+        bool is_run_completed(const bool& done)
+        {
+            std::lock_guard lk{remote_mtx_};
+            return done;
+        }
+
+        void detached_task_started()
+        {
+            std::lock_guard lk{remote_mtx_};
+            ++detached_tasks_;
+        }
+
+        // the wake-up is written under the lock - the destructor takes the lock before the eventfd is closed
+        void detached_task_finished()
+        {
+            std::lock_guard lk{remote_mtx_};
+            --detached_tasks_;
+
+            const std::uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+        }
+
+        bool has_detached_tasks()
+        {
+            std::lock_guard lk{remote_mtx_};
+            return detached_tasks_ > 0;
+        }
+
+        void post(detail::IoOperation& operation)
+        {
+            std::lock_guard lk{remote_mtx_}; // the loop cannot see the operation (and finish) before the wake-up is written
+            remote_queue_.push_back(&operation);
+
+            const std::uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(wake_fd_, &one, sizeof(one));
+        }
+
+        std::size_t drain_remote_queue()
+        {
+            std::vector<detail::IoOperation*> operations;
+            {
+                std::lock_guard lk{remote_mtx_};
+                operations.swap(remote_queue_);
+            }
+
+            for (auto* operation : operations)
+            {
+                if (operation->completed) // finished by the thread-pool backend
+                {
+                    --in_flight_;
+                    operation->awaiting.resume();
+                }
+                else
+                    start(*operation);
+            }
+
+            return operations.size();
+        }
+
+        void start(detail::IoOperation& operation)
+        {
+            if (!on_loop_thread())
+            {
+                post(operation);
+                return;
+            }
+
+            if (operation.code == detail::IoOperation::Code::resume)
+            {
+                operation.awaiting.resume();
+                return;
+            }
+
+            if (operation.code == detail::IoOperation::Code::sleep)
+            {
+                timers_.schedule(*operation.timer, operation.deadline);
+                return;
+            }
+
+            ++in_flight_;
+
+            if (ring_)
+            {
+                io_uring_sqe* sqe = ring_->next_sqe();
+                while (!sqe)
+                {
+                    ring_->submit(false);
+                    sqe = ring_->next_sqe();
+                }
+
+                prepare(*sqe, operation);
+                return;
+            }
+
+            fallback_pool_->submit([this, &operation] {
+                operation.result = operation.perform();
+                operation.completed = true;
+                post(operation);
+            });
+        }
+
+        static void prepare(io_uring_sqe& sqe, const detail::IoOperation& operation) noexcept
+        {
+            using Code = detail::IoOperation::Code;
+
+            switch (operation.code)
+            {
+            case Code::open:
+                sqe.opcode = IORING_OP_OPENAT;
+                sqe.fd = AT_FDCWD;
+                sqe.addr = reinterpret_cast<std::uint64_t>(operation.path);
+                sqe.len = operation.mode;
+                sqe.open_flags = static_cast<std::uint32_t>(operation.flags);
+                break;
+            case Code::read:
+            case Code::write:
+                sqe.opcode = operation.code == Code::read ? IORING_OP_READ : IORING_OP_WRITE;
+                sqe.fd = operation.fd;
+                sqe.addr = reinterpret_cast<std::uint64_t>(operation.buffer);
+                // buffers of 4 GiB or more complete as a short read/write
+                sqe.len = static_cast<std::uint32_t>(std::min<std::size_t>(operation.size, std::numeric_limits<std::uint32_t>::max()));
+                sqe.off = operation.offset;
+                break;
+            case Code::close:
+                sqe.opcode = IORING_OP_CLOSE;
+                sqe.fd = operation.fd;
+                break;
+            case Code::resume:
+            case Code::sleep:
+                break;
+            }
+
+            sqe.user_data = reinterpret_cast<std::uint64_t>(&operation);
+        }
+
+        // io_uring_enter returns at the latest when the next timer is due
+        void arm_timeout()
+        {
+            auto next = timers_.next_event();
+            if (!next || (timeouts_in_flight_ > 0 && armed_timeout_ <= *next))
+                return;
+
+            io_uring_sqe* sqe = ring_->next_sqe();
+            if (!sqe)
+                return;
+
+            const auto now = current_tick();
+            const auto delay = std::chrono::milliseconds{*next > now ? *next - now : 0};
+            timeout_spec_.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(delay).count();
+            timeout_spec_.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(delay % std::chrono::seconds{1}).count();
+
+            sqe->opcode = IORING_OP_TIMEOUT;
+            sqe->addr = reinterpret_cast<std::uint64_t>(&timeout_spec_); // copied by the kernel on submission
+            sqe->len = 1;
+            sqe->user_data = timeout_tag;
+
+            armed_timeout_ = *next;
+            ++timeouts_in_flight_;
+        }
+
+        // an outstanding read of the eventfd lets other threads interrupt io_uring_enter
+        void arm_wake_up()
+        {
+            if (wake_up_armed_)
+                return;
+
+            io_uring_sqe* sqe = ring_->next_sqe();
+            if (!sqe)
+                return;
+
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = wake_fd_;
+            sqe->addr = reinterpret_cast<std::uint64_t>(&wake_up_buffer_);
+            sqe->len = sizeof(wake_up_buffer_);
+            sqe->off = static_cast<std::uint64_t>(-1);
+            sqe->user_data = wake_up_tag;
+            wake_up_armed_ = true;
+        }
+    };
+} // namespace Coroutines
+
+#endif
@@ -0,0 +1,259 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include "frame_allocator.hpp"
+#include "thread_pool.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace Coroutines
+{
+    namespace detail
+    {
+        template <typename T>
+        class TaskResult
+        {
+        public:
+            template <typename TValue>
+            void return_value(TValue&& value) noexcept(std::is_nothrow_constructible_v<T, TValue&&>)
+            {
+                result_.template emplace<1>(std::forward<TValue>(value));
+            }
+
+            void unhandled_exception() noexcept
+            {
+                result_.template emplace<2>(std::current_exception());
+            }
+
+            T get()
+            {
+                if (result_.index() == 2)
+                    std::rethrow_exception(std::get<2>(result_));
+
+                return std::move(std::get<1>(result_));
+            }
+
+        private:
+            std::variant<std::monostate, T, std::exception_ptr> result_;
+        };
+
+        template <>
+        class TaskResult<void>
+        {
+        public:
+            void return_void() const noexcept { }
+
+            void unhandled_exception() noexcept
+            {
+                exception_ = std::current_exception();
+            }
+
+            void get()
+            {
+                if (exception_)
+                    std::rethrow_exception(exception_);
+            }
+
+        private:
+            std::exception_ptr exception_;
+        };
+    } // namespace detail
+
+    // lazily started coroutine - runs when awaited
+    // - the awaiting coroutine is resumed from final_suspend by symmetric transfer,
+    //   so arbitrarily deep co_await chains do not grow the stack
+    template <typename T = void>
+    class [[nodiscard]] Task
+    {
+        static_assert(!std::is_reference_v<T>, "Task<T&> is not supported");
+
+    public:
+        struct promise_type;
+
+        using CoroutineHandle = std::coroutine_handle<promise_type>;
+
+        struct promise_type : PooledPromise, detail::TaskResult<T>
+        {
+            Task get_return_object() noexcept
+            {
+                return Task{CoroutineHandle::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept { return instrumented(std::suspend_always{}); }
+
+            auto final_suspend() noexcept
+            {
+                struct FinalAwaiter
+                {
+                    bool await_ready() const noexcept { return false; }
+
+                    std::coroutine_handle<> await_suspend(CoroutineHandle finished) noexcept
+                    {
+                        if (auto continuation = finished.promise().continuation_)
+                            return continuation;
+                        return std::noop_coroutine();
+                    }
+
+                    void await_resume() const noexcept { }
+                };
+
+                return instrumented(FinalAwaiter{});
+            }
+
+        private:
+            friend class Task;
+
+            std::coroutine_handle<> continuation_;
+        };
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other) noexcept
+            : coroutine_hndl_{std::exchange(other.coroutine_hndl_, nullptr)}
+        { }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (coroutine_hndl_)
+                    coroutine_hndl_.destroy();
+                coroutine_hndl_ = std::exchange(other.coroutine_hndl_, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            if (coroutine_hndl_)
+                coroutine_hndl_.destroy();
+        }
+
+        bool is_ready() const noexcept
+        {
+            return !coroutine_hndl_ || coroutine_hndl_.done();
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct TaskAwaiter
+            {
+                CoroutineHandle coroutine_hndl;
+
+                bool await_ready() const noexcept
+                {
+                    assert(coroutine_hndl && "co_await on an empty (moved-from) Task");
+                    return coroutine_hndl.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+                {
+                    coroutine_hndl.promise().continuation_ = awaiting;
+                    return coroutine_hndl; // start the task without growing the stack
+                }
+
+                T await_resume()
+                {
+                    return coroutine_hndl.promise().get();
+                }
+            };
+
+            return TaskAwaiter{coroutine_hndl_};
+        }
+
+    private:
+        explicit Task(CoroutineHandle coroutine_hndl) noexcept
+            : coroutine_hndl_{coroutine_hndl}
+        { }
+
+        CoroutineHandle coroutine_hndl_ = nullptr;
+    };
+
+    // co_await schedule_on(pool) - the rest of the coroutine runs on a worker of the pool
+    inline auto schedule_on(helpers::ThreadPool& pool) noexcept
+    {
+        return pool.schedule();
+    }
+
+    namespace detail
+    {
+        struct SyncWaitState
+        {
+            std::mutex mtx;
+            std::condition_variable cv;
+            bool done = false;
+
+            void notify()
+            {
+                std::lock_guard lk{mtx};
+                done = true;
+                cv.notify_one(); // under the lock - the waiter may destroy the state right after unlock
+            }
+
+            void wait()
+            {
+                std::unique_lock lk{mtx};
+                cv.wait(lk, [this] { return done; });
+            }
+        };
+
+        // started eagerly, destroys itself on completion
+        struct DetachedCoroutine
+        {
+            struct promise_type : PooledPromise
+            {
+                DetachedCoroutine get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept { }
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+    } // namespace detail
+
+    // blocks the calling thread until the task completes - returns its result or rethrows its exception
+    template <typename T>
+    T sync_wait(Task<T> task)
+    {
+        detail::SyncWaitState state;
+        std::conditional_t<std::is_void_v<T>, std::monostate, std::optional<T>> result;
+        std::exception_ptr exception;
+
+        [](Task<T> task, detail::SyncWaitState& state, auto& result, std::exception_ptr& exception) -> detail::DetachedCoroutine {
+            try
+            {
+                Task<T> awaited = std::move(task); // destroyed before notify - no frame outlives sync_wait
+
+                if constexpr (std::is_void_v<T>)
+                    co_await std::move(awaited);
+                else
+                    result.emplace(co_await std::move(awaited));
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            state.notify();
+        }(std::move(task), state, result, exception);
+
+        state.wait();
+
+        if (exception)
+            std::rethrow_exception(exception);
+
+        if constexpr (!std::is_void_v<T>)
+            return std::move(*result);
+    }
+} // namespace Coroutines
+
+#endif
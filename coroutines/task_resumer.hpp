@@ -0,0 +1,70 @@
+#ifndef TASK_RESUMER_HPP
+#define TASK_RESUMER_HPP
+
+#include "frame_allocator.hpp"
+
+#include <coroutine>
+#include <exception>
+
+namespace Coroutines
+{
+    // owns a lazily started coroutine resumed manually by the caller
+    class TaskResumer
+    {
+    public:
+        struct promise_type;
+
+        using CoroutineHandle = std::coroutine_handle<promise_type>;
+
+        struct promise_type : PooledPromise
+        {
+            TaskResumer get_return_object()
+            {
+                return TaskResumer{CoroutineHandle::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept { return instrumented(std::suspend_always{}); }
+
+            auto final_suspend() noexcept { return instrumented(std::suspend_always{}); }
+
+            void return_void()
+            { }
+
+            void unhandled_exception()
+            {
+                std::terminate();
+            }
+        };
+
+    public:
+        TaskResumer(CoroutineHandle coro_hndl)
+            : coro_hndl_{coro_hndl}
+        { }
+
+        TaskResumer(const TaskResumer&) = delete;
+        TaskResumer& operator=(const TaskResumer&) = delete;
+        TaskResumer(TaskResumer&&) = delete;
+        TaskResumer& operator=(TaskResumer&&) = delete;
+
+        ~TaskResumer() noexcept
+        {
+            if (coro_hndl_)
+                coro_hndl_.destroy();
+        }
+
+        bool resume() const
+        {
+            if (!coro_hndl_ || coro_hndl_.done())
+                return false;
+
+            coro_hndl_.resume(); // resuming suspended coroutine
+
+            return !coro_hndl_.done();
+        }
+
+    private:
+        CoroutineHandle coro_hndl_;
+    };
+} // namespace Coroutines
+
+#endif
@@ -0,0 +1,156 @@
+#include "task.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+using Coroutines::Task;
+
+Task<int> answer()
+{
+    co_return 42;
+}
+
+Task<std::string> describe()
+{
+    const int value = co_await answer();
+    co_return "answer: "s + std::to_string(value);
+}
+
+TEST_CASE("task - lazy start and chaining")
+{
+    bool started = false;
+
+    auto task = [](bool& started) -> Task<int> {
+        started = true;
+        co_return 665 + 1;
+    }(started);
+
+    CHECK_FALSE(started);
+    CHECK(Coroutines::sync_wait(std::move(task)) == 666);
+    CHECK(started);
+
+    CHECK(Coroutines::sync_wait(describe()) == "answer: 42");
+}
+
+Task<void> fail()
+{
+    throw std::runtime_error{"task error"};
+    co_return;
+}
+
+TEST_CASE("task - exceptions are propagated to the awaiting coroutine")
+{
+    auto caller = []() -> Task<std::string> {
+        try
+        {
+            co_await fail();
+        }
+        catch (const std::runtime_error& e)
+        {
+            co_return e.what();
+        }
+
+        co_return "no error";
+    };
+
+    CHECK(Coroutines::sync_wait(caller()) == "task error");
+    CHECK_THROWS_AS(Coroutines::sync_wait(fail()), std::runtime_error);
+}
+
+Task<long> sum_to(int n)
+{
+    if (n == 0)
+        co_return 0;
+
+    co_return n + co_await sum_to(n - 1);
+}
+
+// address of the stack frame running the innermost coroutine of a chain of n co_awaits
+Task<std::uintptr_t> innermost_frame_address(int n)
+{
+    if (n == 0)
+        co_return reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+
+    co_return co_await innermost_frame_address(n - 1);
+}
+
+TEST_CASE("task - deep co_await chain does not grow the stack")
+{
+    // symmetric transfer becomes a tail call only with sibling call optimization (-O2) and without sanitizers -
+    // a chain that deep would overflow the stack in other builds
+    const auto shallow = Coroutines::sync_wait(innermost_frame_address(1));
+    const auto deep = Coroutines::sync_wait(innermost_frame_address(1'000));
+    const auto growth = shallow > deep ? shallow - deep : deep - shallow;
+
+    if (growth > 4096)
+        SKIP("symmetric transfer is not a tail call in this build - 1'000 nested co_awaits took " << growth << " bytes of stack");
+
+    constexpr int depth = 1'000'000;
+    CHECK(Coroutines::sync_wait(sum_to(depth)) == static_cast<long>(depth) * (depth + 1) / 2);
+}
+
+TEST_CASE("thread pool - schedule_on")
+{
+    helpers::ThreadPool pool{4};
+
+    auto task = [](helpers::ThreadPool& pool) -> Task<std::thread::id> {
+        co_await Coroutines::schedule_on(pool);
+        REQUIRE(pool.is_worker_thread());
+        co_return std::this_thread::get_id();
+    }(pool);
+
+    CHECK(Coroutines::sync_wait(std::move(task)) != std::this_thread::get_id());
+}
+
+TEST_CASE("thread pool - work scheduled from workers is stolen by idle workers")
+{
+    constexpr int task_count = 10'000;
+
+    helpers::ThreadPool pool{4};
+    std::atomic<int> counter = 0;
+    std::latch done{task_count};
+
+    pool.submit([&] {
+        for (int i = 0; i < task_count; ++i) // all pushed to the local deque of a single worker
+        {
+            pool.submit([&] {
+                counter.fetch_add(1, std::memory_order_relaxed);
+                done.count_down();
+            });
+        }
+    });
+
+    done.wait();
+
+    CHECK(counter == task_count);
+}
+
+TEST_CASE("work-stealing deque")
+{
+    helpers::WorkStealingDeque deque{2};
+
+    std::vector<int> tags(100);
+    auto handle = [&](int i) { return std::coroutine_handle<>::from_address(&tags[i]); };
+
+    for (int i = 0; i < 100; ++i) // grows beyond the initial capacity
+        deque.push(handle(i));
+
+    CHECK(deque.steal() == handle(0)); // FIFO for thieves
+    CHECK(deque.pop() == handle(99));  // LIFO for the owner
+
+    int remaining = 0;
+    while (deque.pop())
+        ++remaining;
+
+    CHECK(remaining == 98);
+    CHECK(deque.empty());
+    CHECK_FALSE(deque.steal());
+}
@@ -0,0 +1,247 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Coroutines
+{
+    // hierarchical timing wheel (Varghese & Lauck) with intrusive timers
+    // - 6 levels of 64 slots, level k slot spans 64^k ticks - O(1) insert and cancel
+    // - timers from higher levels are cascaded down when their slot is reached
+    // - the top level wraps around; timers longer than its span are re-inserted on the way
+    // - per-level occupancy bitmaps make finding the next expiry O(levels)
+    class TimerWheel
+    {
+    public:
+        using Tick = std::uint64_t;
+
+        static constexpr unsigned slot_bits = 6;
+        static constexpr unsigned slot_count = 1u << slot_bits;
+        static constexpr unsigned level_count = 6;
+        static constexpr Tick top_slot_span = Tick{1} << (slot_bits * (level_count - 1));
+        static constexpr Tick max_span = top_slot_span * (slot_count - 1);
+
+        class Timer
+        {
+        public:
+            explicit Timer(void (*on_expired)(Timer&) noexcept) noexcept
+                : on_expired_{on_expired}
+            { }
+
+            Timer(const Timer&) = delete;
+            Timer& operator=(const Timer&) = delete;
+
+            bool is_scheduled() const noexcept { return next_ != nullptr; }
+            Tick expiry() const noexcept { return expiry_; }
+
+        private:
+            friend class TimerWheel;
+
+            Timer* prev_ = nullptr;
+            Timer* next_ = nullptr;
+            Tick expiry_ = 0;
+            std::uint8_t level_ = 0;
+            std::uint8_t slot_ = 0;
+            void (*on_expired_)(Timer&) noexcept;
+
+            Timer() noexcept // list sentinel
+                : prev_{this}
+                , next_{this}
+                , on_expired_{nullptr}
+            { }
+
+            void link_before(Timer& position) noexcept
+            {
+                prev_ = position.prev_;
+                next_ = &position;
+                position.prev_->next_ = this;
+                position.prev_ = this;
+            }
+
+            void unlink() noexcept
+            {
+                prev_->next_ = next_;
+                next_->prev_ = prev_;
+                prev_ = next_ = nullptr;
+            }
+        };
+
+        TimerWheel() = default;
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        Tick now() const noexcept { return current_; }
+        std::size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        // timers expiring at or before now() fire on the next advance()
+        void schedule(Timer& timer, Tick expiry) noexcept
+        {
+            assert(!timer.is_scheduled());
+
+            timer.expiry_ = std::max(expiry, current_ + 1);
+            place(timer);
+            ++size_;
+        }
+
+        void cancel(Timer& timer) noexcept
+        {
+            if (!timer.is_scheduled())
+                return;
+
+            remove(timer);
+            --size_;
+        }
+
+        // earliest tick at which advance() has work to do (fires timers or cascades them)
+        std::optional<Tick> next_event() const noexcept
+        {
+            if (expired_.next_ != &expired_)
+                return current_;
+
+            return next_wheel_event();
+        }
+
+        // moves the wheel to `now` and calls on_expired for every due timer
+        // - callbacks may schedule and cancel timers (including other due ones)
+        std::size_t advance(Tick now) noexcept
+        {
+            while (true)
+            {
+                auto next = next_wheel_event();
+                if (!next || *next > now)
+                    break;
+
+                std::array<bool, level_count> reached{};
+                for (unsigned level = 0; level < level_count; ++level)
+                    reached[level] = next_event_on(level) == next;
+
+                current_ = *next;
+
+                for (unsigned level = 0; level < level_count; ++level)
+                {
+                    if (reached[level])
+                        cascade(level, slot_of(current_, level));
+                }
+            }
+
+            current_ = std::max(current_, now);
+
+            std::size_t fired = 0;
+            while (expired_.next_ != &expired_)
+            {
+                Timer& timer = *expired_.next_;
+                timer.unlink();
+                --size_;
+                ++fired;
+
+                timer.on_expired_(timer);
+            }
+
+            return fired;
+        }
+
+    private:
+        static constexpr std::uint8_t expired_level = level_count;
+
+        std::array<std::array<Timer, slot_count>, level_count> slots_{};
+        std::array<std::uint64_t, level_count> occupied_{};
+        Timer expired_;
+        Tick current_ = 0;
+        std::size_t size_ = 0;
+
+        static unsigned slot_of(Tick tick, unsigned level) noexcept
+        {
+            return static_cast<unsigned>(tick >> (slot_bits * level)) & (slot_count - 1);
+        }
+
+        std::optional<Tick> next_wheel_event() const noexcept
+        {
+            std::optional<Tick> earliest;
+            for (unsigned level = 0; level < level_count; ++level)
+            {
+                if (auto tick = next_event_on(level); tick && (!earliest || *tick < *earliest))
+                    earliest = tick;
+            }
+
+            return earliest;
+        }
+
+        // tick at which the first occupied slot of the level is reached
+        // - slots of lower levels always lie ahead of the current slot within the current rotation of the level above
+        std::optional<Tick> next_event_on(unsigned level) const noexcept
+        {
+            const unsigned shift = slot_bits * level;
+            const unsigned current_slot = slot_of(current_, level);
+
+            if (level == level_count - 1)
+            {
+                if (!occupied_[level])
+                    return std::nullopt;
+
+                const auto distance = static_cast<unsigned>(std::countr_zero(std::rotr(occupied_[level], static_cast<int>(current_slot))));
+                return (current_ >> shift << shift) + (Tick{distance} << shift);
+            }
+
+            const std::uint64_t later_slots = current_slot == slot_count - 1 ? 0 : occupied_[level] & (~std::uint64_t{0} << (current_slot + 1));
+            if (!later_slots)
+                return std::nullopt;
+
+            const unsigned rotation_shift = shift + slot_bits;
+            return (current_ >> rotation_shift << rotation_shift) | (Tick{static_cast<unsigned>(std::countr_zero(later_slots))} << shift);
+        }
+
+        // level = the highest 6-bit digit in which the expiry differs from the current tick
+        void place(Timer& timer) noexcept
+        {
+            if (timer.expiry_ <= current_)
+            {
+                timer.level_ = expired_level;
+                timer.link_before(expired_);
+                return;
+            }
+
+            const Tick target = current_ + std::min(timer.expiry_ - current_, max_span);
+            const unsigned level = std::min<unsigned>(static_cast<unsigned>(std::bit_width(target ^ current_) - 1) / slot_bits, level_count - 1);
+            const unsigned slot = slot_of(target, level);
+
+            timer.level_ = static_cast<std::uint8_t>(level);
+            timer.slot_ = static_cast<std::uint8_t>(slot);
+            timer.link_before(slots_[level][slot]);
+            occupied_[level] |= std::uint64_t{1} << slot;
+        }
+
+        void remove(Timer& timer) noexcept
+        {
+            timer.unlink();
+
+            if (timer.level_ == expired_level)
+                return;
+
+            Timer& sentinel = slots_[timer.level_][timer.slot_];
+            if (sentinel.next_ == &sentinel)
+                occupied_[timer.level_] &= ~(std::uint64_t{1} << timer.slot_);
+        }
+
+        void cascade(unsigned level, unsigned slot) noexcept
+        {
+            Timer& sentinel = slots_[level][slot];
+            occupied_[level] &= ~(std::uint64_t{1} << slot);
+
+            while (sentinel.next_ != &sentinel)
+            {
+                Timer& timer = *sentinel.next_;
+                timer.unlink();
+                place(timer); // lands on a lower level or in the expired list
+            }
+        }
+    };
+} // namespace Coroutines
+
+#endif
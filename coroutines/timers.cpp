@@ -0,0 +1,234 @@
+#include "io_backends.hpp"
+#include "io_context.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+#include "timer_wheel.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+using namespace std::literals;
+using Coroutines::IoContext;
+using Coroutines::Task;
+using Coroutines::TimerWheel;
+
+namespace
+{
+    struct RecordingTimer : TimerWheel::Timer
+    {
+        int id;
+        std::vector<std::pair<int, TimerWheel::Tick>>* fired;
+        TimerWheel* wheel;
+
+        RecordingTimer(int id, std::vector<std::pair<int, TimerWheel::Tick>>& fired, TimerWheel& wheel)
+            : TimerWheel::Timer{[](TimerWheel::Timer& timer) noexcept {
+                auto& self = static_cast<RecordingTimer&>(timer);
+                self.fired->emplace_back(self.id, self.wheel->now());
+            }}
+            , id{id}
+            , fired{&fired}
+            , wheel{&wheel}
+        { }
+    };
+}
+
+TEST_CASE("TimerWheel fires timers in order of expiry")
+{
+    TimerWheel wheel;
+    std::vector<std::pair<int, TimerWheel::Tick>> fired;
+    std::deque<RecordingTimer> timers;
+
+    const std::vector<TimerWheel::Tick> expiries = {5, 1, 64, 63, 4096, 65, 300'000, 4095};
+    for (int i = 0; i < static_cast<int>(expiries.size()); ++i)
+        wheel.schedule(timers.emplace_back(i, fired, wheel), expiries[i]);
+
+    REQUIRE(wheel.size() == expiries.size());
+
+    while (auto next = wheel.next_event())
+        wheel.advance(*next);
+
+    REQUIRE(wheel.empty());
+    REQUIRE(fired == std::vector<std::pair<int, TimerWheel::Tick>>{{1, 1}, {0, 5}, {3, 63}, {2, 64}, {5, 65}, {7, 4095}, {4, 4096}, {6, 300'000}});
+}
+
+TEST_CASE("TimerWheel - advancing in large steps fires every due timer")
+{
+    TimerWheel wheel;
+    std::vector<std::pair<int, TimerWheel::Tick>> fired;
+    std::deque<RecordingTimer> timers;
+
+    for (int i = 0; i < 1000; ++i)
+        wheel.schedule(timers.emplace_back(i, fired, wheel), TimerWheel::Tick(i) * 37 + 1);
+
+    wheel.advance(10'000);
+    REQUIRE(fired.size() == 271);
+    REQUIRE(wheel.size() == 729);
+
+    wheel.advance(TimerWheel::max_span * 2);
+    REQUIRE(fired.size() == 1000);
+}
+
+TEST_CASE("TimerWheel - cancelled timers do not fire")
+{
+    TimerWheel wheel;
+    std::vector<std::pair<int, TimerWheel::Tick>> fired;
+    RecordingTimer first{1, fired, wheel};
+    RecordingTimer second{2, fired, wheel};
+
+    wheel.schedule(first, 100);
+    wheel.schedule(second, 100);
+    wheel.cancel(first);
+    REQUIRE(!first.is_scheduled());
+    REQUIRE(wheel.next_event() == 64); // cascade from level 1
+
+    wheel.advance(99);
+    REQUIRE(fired.empty());
+
+    wheel.advance(1000);
+    REQUIRE(fired == std::vector<std::pair<int, TimerWheel::Tick>>{{2, 1000}});
+}
+
+TEST_CASE("TimerWheel - timers beyond max_span")
+{
+    TimerWheel wheel;
+    std::vector<std::pair<int, TimerWheel::Tick>> fired;
+    RecordingTimer timer{1, fired, wheel};
+
+    const auto expiry = TimerWheel::max_span * 3 + 12345;
+    wheel.schedule(timer, expiry);
+
+    while (auto next = wheel.next_event())
+        wheel.advance(*next);
+
+    REQUIRE(fired == std::vector<std::pair<int, TimerWheel::Tick>>{{1, expiry}});
+}
+
+TEST_CASE("sleep_for suspends the coroutine for at least the given duration")
+{
+    for (auto backend : available_backends())
+    {
+        IoContext io{backend};
+
+        auto elapsed = io.run([](IoContext& io) -> Task<std::chrono::steady_clock::duration> {
+            auto start = std::chrono::steady_clock::now();
+            co_await io.sleep_for(30ms);
+            co_return std::chrono::steady_clock::now() - start;
+        }(io));
+
+        CHECK(elapsed >= 30ms);
+        CHECK(elapsed < 1s);
+        CHECK(io.pending_timers() == 0);
+    }
+}
+
+TEST_CASE("concurrent sleeps are resumed in order of deadlines")
+{
+    for (auto backend : available_backends())
+    {
+        IoContext io{backend};
+        std::vector<int> order;
+
+        auto sleeper = [](IoContext& io, std::vector<int>& order, int id) -> Task<> {
+            co_await io.sleep_for(id * 10ms);
+            order.push_back(id);
+        };
+
+        io.run([](IoContext& io, auto sleeper, std::vector<int>& order) -> Task<> {
+            for (int id : {4, 1, 3, 2}) // a task that times out keeps running in the background
+                co_await io.with_timeout(sleeper(io, order, id), 0ms);
+        }(io, sleeper, order));
+
+        while (io.run_one())
+        { }
+
+        CHECK(order == std::vector{1, 2, 3, 4});
+        CHECK(io.pending_timers() == 0);
+    }
+}
+
+TEST_CASE("with_timeout")
+{
+    for (auto backend : available_backends())
+    {
+        IoContext io{backend};
+
+        auto work = [](IoContext& io, std::chrono::milliseconds duration) -> Task<int> {
+            co_await io.sleep_for(duration);
+            co_return 42;
+        };
+
+        auto await_with_timeout = []<typename T>(IoContext& io, Task<T> task, std::chrono::milliseconds timeout) -> Task<decltype(io.with_timeout(std::move(task), timeout).await_resume())> {
+            co_return co_await io.with_timeout(std::move(task), timeout);
+        };
+
+        SECTION("task completes in time")
+        {
+            auto result = io.run(await_with_timeout(io, work(io, 5ms), 1s));
+            CHECK(result == 42);
+        }
+
+        SECTION("timeout expires first")
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto result = io.run(await_with_timeout(io, work(io, 200ms), 10ms));
+            CHECK(result == std::nullopt);
+            CHECK(std::chrono::steady_clock::now() - start < 200ms);
+
+            while (io.run_one()) // let the abandoned task finish
+            { }
+        }
+
+        SECTION("exception thrown by the task")
+        {
+            auto failing = [](IoContext& io) -> Task<> {
+                co_await io.sleep_for(1ms);
+                throw std::runtime_error{"error"};
+            };
+
+            CHECK_THROWS_AS(io.run(await_with_timeout(io, failing(io), 1s)), std::runtime_error);
+        }
+
+        SECTION("task completing on another thread")
+        {
+            helpers::ThreadPool pool{2};
+
+            auto on_pool = [](helpers::ThreadPool& pool) -> Task<int> {
+                co_await Coroutines::schedule_on(pool);
+                co_return 7;
+            };
+
+            CHECK(io.run(await_with_timeout(io, on_pool(pool), 1s)) == 7);
+        }
+    }
+}
+
+TEST_CASE("with_timeout - the context waits for a task which lost the race")
+{
+    for (auto backend : available_backends())
+    {
+        bool finished = false;
+
+        {
+            IoContext io{backend};
+
+            auto slow = [](IoContext& io, bool& finished) -> Task<int> {
+                co_await io.sleep_for(50ms);
+                finished = true;
+                co_return 42;
+            };
+
+            auto race = [](IoContext& io, Task<int> task) -> Task<std::optional<int>> {
+                co_return co_await io.with_timeout(std::move(task), 1ms);
+            };
+
+            CHECK(io.run(race(io, slow(io, finished))) == std::nullopt);
+        } // the destructor drives the loop until the slow task completes
+
+        CHECK(finished);
+    }
+}
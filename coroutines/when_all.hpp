@@ -0,0 +1,392 @@
+#ifndef WHEN_ALL_HPP
+#define WHEN_ALL_HPP
+
+#include "awaitable_traits.hpp"
+#include "frame_allocator.hpp"
+#include "task.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Coroutines
+{
+    template <typename T>
+    using non_void_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    namespace detail
+    {
+        template <typename T>
+        inline constexpr bool is_task_v = false;
+
+        template <typename T>
+        inline constexpr bool is_task_v<Task<T>> = true;
+
+        template <typename T>
+        concept TaskRange = std::ranges::input_range<T> && is_task_v<std::ranges::range_value_t<T>>;
+
+        template <typename T>
+        struct TaskTraits;
+
+        template <typename T>
+        struct TaskTraits<Task<T>>
+        {
+            using value_type = T;
+        };
+
+        // counts down finished children without locking - the last one resumes the awaiting coroutine
+        // - starts at count + 1 so that children finishing before the awaiting coroutine has suspended do not resume it
+        class WhenAllLatch
+        {
+        public:
+            explicit WhenAllLatch(std::size_t count) noexcept
+                : count_{count + 1}
+            { }
+
+            // false if all children have already finished - the awaiting coroutine continues immediately
+            bool suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                awaiting_ = awaiting;
+                return count_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+            }
+
+            std::coroutine_handle<> arrive() noexcept
+            {
+                if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    return awaiting_;
+                return std::noop_coroutine();
+            }
+
+        private:
+            std::atomic<std::size_t> count_;
+            std::coroutine_handle<> awaiting_;
+        };
+
+        // the first child to finish wins and requests the others to stop
+        class WhenAnyLatch : public WhenAllLatch
+        {
+        public:
+            static constexpr std::size_t no_winner = std::numeric_limits<std::size_t>::max();
+
+            WhenAnyLatch(std::size_t count, std::stop_source stop) noexcept
+                : WhenAllLatch{count}
+                , stop_{std::move(stop)}
+            { }
+
+            void finished(std::size_t index) noexcept
+            {
+                std::size_t expected = no_winner;
+                if (winner_.compare_exchange_strong(expected, index, std::memory_order_acq_rel))
+                    stop_.request_stop();
+            }
+
+            std::size_t winner() const noexcept
+            {
+                return winner_.load(std::memory_order_acquire);
+            }
+
+        private:
+            std::atomic<std::size_t> winner_ = no_winner;
+            std::stop_source stop_;
+        };
+
+        // wraps a task - counts down the latch when the task finishes (with a result or an exception)
+        template <typename T>
+        class WhenAllChild
+        {
+        public:
+            struct promise_type : PooledPromise, TaskResult<T>
+            {
+                WhenAllLatch* latch = nullptr;
+
+                WhenAllChild get_return_object() noexcept
+                {
+                    return WhenAllChild{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+
+                auto initial_suspend() noexcept { return instrumented(std::suspend_always{}); }
+
+                auto final_suspend() noexcept
+                {
+                    struct FinalAwaiter
+                    {
+                        bool await_ready() const noexcept { return false; }
+
+                        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> child) noexcept
+                        {
+                            return child.promise().latch->arrive();
+                        }
+
+                        void await_resume() const noexcept { }
+                    };
+
+                    return instrumented(FinalAwaiter{});
+                }
+            };
+
+            WhenAllChild(WhenAllChild&& other) noexcept
+                : coroutine_hndl_{std::exchange(other.coroutine_hndl_, nullptr)}
+            { }
+
+            WhenAllChild& operator=(WhenAllChild&&) = delete;
+
+            ~WhenAllChild()
+            {
+                if (coroutine_hndl_)
+                    coroutine_hndl_.destroy();
+            }
+
+            template <typename TLauncher>
+            void start(WhenAllLatch& latch, TLauncher& launch)
+            {
+                coroutine_hndl_.promise().latch = &latch;
+                launch(coroutine_hndl_);
+            }
+
+            // rethrows the exception of the task
+            non_void_t<T> result()
+            {
+                if constexpr (std::is_void_v<T>)
+                {
+                    coroutine_hndl_.promise().get();
+                    return {};
+                }
+                else
+                    return coroutine_hndl_.promise().get();
+            }
+
+        private:
+            explicit WhenAllChild(std::coroutine_handle<promise_type> coroutine_hndl) noexcept
+                : coroutine_hndl_{coroutine_hndl}
+            { }
+
+            std::coroutine_handle<promise_type> coroutine_hndl_;
+        };
+
+        template <typename T>
+        WhenAllChild<T> make_when_all_child(Task<T> task)
+        {
+            if constexpr (std::is_void_v<T>)
+                co_await std::move(task);
+            else
+                co_return co_await std::move(task);
+        }
+
+        template <typename T>
+        WhenAllChild<T> make_when_any_child(Task<T> task, WhenAnyLatch& latch, std::size_t index)
+        {
+            struct ReportFinished
+            {
+                WhenAnyLatch& latch;
+                std::size_t index;
+
+                ~ReportFinished() { latch.finished(index); } // also when the task throws
+            } report_finished{latch, index};
+
+            if constexpr (std::is_void_v<T>)
+                co_await std::move(task);
+            else
+                co_return co_await std::move(task);
+        }
+
+        struct InlineLauncher
+        {
+            void operator()(std::coroutine_handle<> child) const
+            {
+                child.resume(); // runs until its first suspension point
+            }
+        };
+
+        template <Scheduler TScheduler>
+        struct ScheduleLauncher
+        {
+            TScheduler& scheduler;
+
+            void operator()(std::coroutine_handle<> child) const
+            {
+                scheduler.schedule(child);
+            }
+        };
+
+        template <typename TStartChildren>
+        struct WhenAllAwaiter
+        {
+            WhenAllLatch& latch;
+            TStartChildren start_children;
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> awaiting)
+            {
+                start_children();
+                return latch.suspend(awaiting);
+            }
+
+            void await_resume() const noexcept { }
+        };
+
+        template <typename TLauncher, typename... Ts>
+        Task<std::tuple<non_void_t<Ts>...>> when_all(TLauncher launch, Task<Ts>... tasks)
+        {
+            WhenAllLatch latch{sizeof...(Ts)};
+            std::tuple children{make_when_all_child(std::move(tasks))...};
+
+            co_await WhenAllAwaiter{latch, [&] {
+                std::apply([&](auto&... child) { (child.start(latch, launch), ...); }, children);
+            }};
+
+            // braced initialization keeps the order - the exception of the first failed task is rethrown
+            co_return std::apply([](auto&... child) { return std::tuple<non_void_t<Ts>...>{child.result()...}; }, children);
+        }
+
+        template <typename TLauncher, typename T>
+        Task<std::conditional_t<std::is_void_v<T>, void, std::vector<non_void_t<T>>>> when_all(TLauncher launch, std::vector<Task<T>> tasks)
+        {
+            WhenAllLatch latch{tasks.size()};
+
+            std::vector<WhenAllChild<T>> children;
+            children.reserve(tasks.size());
+            for (auto& task : tasks)
+                children.push_back(make_when_all_child(std::move(task)));
+
+            co_await WhenAllAwaiter{latch, [&] {
+                for (auto& child : children)
+                    child.start(latch, launch);
+            }};
+
+            if constexpr (std::is_void_v<T>)
+            {
+                for (auto& child : children)
+                    child.result();
+            }
+            else
+            {
+                std::vector<T> results;
+                results.reserve(children.size());
+                for (auto& child : children)
+                    results.push_back(child.result());
+                co_return results;
+            }
+        }
+
+        template <typename TLauncher, typename... Ts, std::size_t... Is>
+        Task<std::variant<non_void_t<Ts>...>> when_any(TLauncher launch, std::stop_source stop, std::index_sequence<Is...>, Task<Ts>... tasks)
+        {
+            WhenAnyLatch latch{sizeof...(Ts), std::move(stop)};
+            std::tuple children{make_when_any_child(std::move(tasks), latch, Is)...};
+
+            co_await WhenAllAwaiter{latch, [&] {
+                std::apply([&](auto&... child) { (child.start(latch, launch), ...); }, children);
+            }};
+
+            std::optional<std::variant<non_void_t<Ts>...>> result;
+            ((latch.winner() == Is ? (result.emplace(std::in_place_index<Is>, std::get<Is>(children).result()), 0) : 0), ...);
+            co_return std::move(*result);
+        }
+
+        template <typename TLauncher, typename T>
+        Task<std::pair<std::size_t, non_void_t<T>>> when_any(TLauncher launch, std::stop_source stop, std::vector<Task<T>> tasks)
+        {
+            if (tasks.empty())
+                throw std::invalid_argument{"when_any: no tasks"};
+
+            WhenAnyLatch latch{tasks.size(), std::move(stop)};
+
+            std::vector<WhenAllChild<T>> children;
+            children.reserve(tasks.size());
+            for (std::size_t i = 0; i < tasks.size(); ++i)
+                children.push_back(make_when_any_child(std::move(tasks[i]), latch, i));
+
+            co_await WhenAllAwaiter{latch, [&] {
+                for (auto& child : children)
+                    child.start(latch, launch);
+            }};
+
+            const std::size_t winner = latch.winner();
+            co_return std::pair<std::size_t, non_void_t<T>>{winner, children[winner].result()};
+        }
+
+        template <TaskRange TRange>
+        auto to_task_vector(TRange&& tasks)
+        {
+            using T = typename TaskTraits<std::ranges::range_value_t<TRange>>::value_type;
+
+            std::vector<Task<T>> result;
+            for (auto&& task : tasks)
+                result.push_back(std::move(task));
+            return result;
+        }
+    } // namespace detail
+
+    // co_await when_all(tasks...) - std::tuple of results (std::monostate for Task<void>)
+    // - the children are started one after another on the awaiting thread and run until their first suspension
+    // - completes when all children have finished; the exception of the first failed task (in argument order) is rethrown
+    template <typename... Ts>
+    Task<std::tuple<non_void_t<Ts>...>> when_all(Task<Ts>... tasks)
+    {
+        return detail::when_all(detail::InlineLauncher{}, std::move(tasks)...);
+    }
+
+    // every child is started on the scheduler - e.g. children of when_all(pool, ...) run in parallel on the pool
+    template <Scheduler TScheduler, typename... Ts>
+    Task<std::tuple<non_void_t<Ts>...>> when_all(TScheduler& scheduler, Task<Ts>... tasks)
+    {
+        return detail::when_all(detail::ScheduleLauncher<TScheduler>{scheduler}, std::move(tasks)...);
+    }
+
+    // co_await when_all(range_of_tasks) - std::vector of results in the order of the range (Task<void> for void tasks)
+    template <detail::TaskRange TRange>
+    auto when_all(TRange&& tasks)
+    {
+        return detail::when_all(detail::InlineLauncher{}, detail::to_task_vector(std::forward<TRange>(tasks)));
+    }
+
+    template <Scheduler TScheduler, detail::TaskRange TRange>
+    auto when_all(TScheduler& scheduler, TRange&& tasks)
+    {
+        return detail::when_all(detail::ScheduleLauncher<TScheduler>{scheduler}, detail::to_task_vector(std::forward<TRange>(tasks)));
+    }
+
+    // co_await when_any(stop_source, tasks...) - std::variant holding the result of the first task to finish (its index is the variant index)
+    // - stop is requested on the stop_source as soon as the first task finishes - the other tasks
+    //   should observe tokens obtained from it and return early
+    // - completes when all children have finished (no task outlives the call); exceptions of the losers are ignored
+    template <typename... Ts>
+    Task<std::variant<non_void_t<Ts>...>> when_any(std::stop_source stop, Task<Ts>... tasks)
+    {
+        static_assert(sizeof...(Ts) > 0, "when_any requires at least one task");
+        return detail::when_any(detail::InlineLauncher{}, std::move(stop), std::index_sequence_for<Ts...>{}, std::move(tasks)...);
+    }
+
+    template <Scheduler TScheduler, typename... Ts>
+    Task<std::variant<non_void_t<Ts>...>> when_any(TScheduler& scheduler, std::stop_source stop, Task<Ts>... tasks)
+    {
+        static_assert(sizeof...(Ts) > 0, "when_any requires at least one task");
+        return detail::when_any(detail::ScheduleLauncher<TScheduler>{scheduler}, std::move(stop), std::index_sequence_for<Ts...>{}, std::move(tasks)...);
+    }
+
+    // co_await when_any(stop_source, range_of_tasks) - std::pair{index of the winner, its result}
+    template <detail::TaskRange TRange>
+    auto when_any(std::stop_source stop, TRange&& tasks)
+    {
+        return detail::when_any(detail::InlineLauncher{}, std::move(stop), detail::to_task_vector(std::forward<TRange>(tasks)));
+    }
+
+    template <Scheduler TScheduler, detail::TaskRange TRange>
+    auto when_any(TScheduler& scheduler, std::stop_source stop, TRange&& tasks)
+    {
+        return detail::when_any(detail::ScheduleLauncher<TScheduler>{scheduler}, std::move(stop), detail::to_task_vector(std::forward<TRange>(tasks)));
+    }
+} // namespace Coroutines
+
+#endif
@@ -0,0 +1,384 @@
+#ifndef DATASET_CACHE_HPP
+#define DATASET_CACHE_HPP
+
+#include "helpers.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace helpers::cache
+{
+    // everything that determines the content of a generated dataset
+    struct DatasetKey
+    {
+        std::string engine = "pcg32";
+        std::uint64_t seed = 42;
+        std::uint64_t size = 0;
+        std::int64_t low = -100;
+        std::int64_t high = 100;
+        std::string distribution = "uniform_int";
+
+        std::string to_string() const
+        {
+            return "engine=" + engine + ";seed=" + std::to_string(seed) + ";size=" + std::to_string(size)
+                + ";low=" + std::to_string(low) + ";high=" + std::to_string(high) + ";distribution=" + distribution;
+        }
+
+        bool operator==(const DatasetKey&) const = default;
+    };
+
+    enum class Validation
+    {
+        header_only,
+        checksum
+    };
+
+    namespace detail
+    {
+        // FNV-1a
+        constexpr std::uint64_t hash_bytes(std::string_view bytes)
+        {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (unsigned char c : bytes)
+                hash = (hash ^ c) * 1099511628211ULL;
+            return hash;
+        }
+
+        // word-at-a-time mixing - fast enough to validate gigabytes on open
+        inline std::uint64_t checksum(std::span<const std::byte> data)
+        {
+            constexpr std::uint64_t prime_1 = 0x9E37'79B1'85EB'CA87ULL;
+            constexpr std::uint64_t prime_2 = 0xC2B2'AE3D'27D4'EB4FULL;
+
+            std::uint64_t lanes[4] = {prime_1, prime_2, ~prime_1, ~prime_2};
+
+            size_t pos = 0;
+            for (; pos + 32 <= data.size(); pos += 32)
+            {
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    std::uint64_t word;
+                    std::memcpy(&word, data.data() + pos + 8 * lane, sizeof(word));
+                    lanes[lane] = std::rotl(lanes[lane] + word * prime_2, 31) * prime_1;
+                }
+            }
+
+            std::uint64_t hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18) + data.size();
+            for (; pos < data.size(); ++pos)
+                hash = (hash ^ std::to_integer<std::uint64_t>(data[pos])) * prime_1;
+
+            hash ^= hash >> 33;
+            hash *= prime_2;
+            hash ^= hash >> 29;
+
+            return hash;
+        }
+
+        // together with the element size tells int from float (or unsigned) data of the same key
+        enum class ElementType : std::uint32_t
+        {
+            signed_integer = 1,
+            unsigned_integer,
+            floating_point,
+            other // e.g. structs - only the size is checked
+        };
+
+        template <typename T>
+        constexpr ElementType element_type_of() noexcept
+        {
+            if constexpr (std::is_enum_v<T>)
+                return element_type_of<std::underlying_type_t<T>>();
+            else if constexpr (std::is_floating_point_v<T>)
+                return ElementType::floating_point;
+            else if constexpr (std::is_integral_v<T>)
+                return std::is_signed_v<T> ? ElementType::signed_integer : ElementType::unsigned_integer;
+            else
+                return ElementType::other;
+        }
+
+        struct FileHeader
+        {
+            static constexpr char expected_magic[8] = {'H', 'L', 'P', 'D', 'S', 'E', 'T', '\0'};
+            static constexpr std::uint32_t current_version = 2;
+            static constexpr std::uint64_t data_offset = 4096; // keeps mapped data page aligned
+
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t element_size;
+            std::uint64_t element_count;
+            std::uint64_t checksum;
+            std::uint32_t key_length;
+            ElementType element_type;
+            char key[4096 - 40];
+        };
+
+        static_assert(sizeof(FileHeader) == FileHeader::data_offset);
+
+        class FileDescriptor
+        {
+        public:
+            explicit FileDescriptor(int fd)
+                : fd_{fd}
+            { }
+
+            FileDescriptor(const FileDescriptor&) = delete;
+            FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+            ~FileDescriptor()
+            {
+                if (fd_ != -1)
+                    ::close(fd_);
+            }
+
+            int get() const { return fd_; }
+
+        private:
+            int fd_;
+        };
+
+        [[noreturn]] inline void throw_errno(const std::string& what)
+        {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+    } // namespace detail
+
+    // read-only view of a dataset mapped from the cache file
+    template <typename T>
+    class MappedDataset
+    {
+    public:
+        MappedDataset(void* mapping, size_t mapping_size, size_t element_count)
+            : mapping_{mapping}
+            , mapping_size_{mapping_size}
+            , data_{reinterpret_cast<const T*>(static_cast<const std::byte*>(mapping) + detail::FileHeader::data_offset), element_count}
+        { }
+
+        MappedDataset(const MappedDataset&) = delete;
+        MappedDataset& operator=(const MappedDataset&) = delete;
+
+        MappedDataset(MappedDataset&& other) noexcept
+            : mapping_{std::exchange(other.mapping_, nullptr)}
+            , mapping_size_{std::exchange(other.mapping_size_, 0)}
+            , data_{std::exchange(other.data_, {})}
+        { }
+
+        MappedDataset& operator=(MappedDataset&& other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                mapping_ = std::exchange(other.mapping_, nullptr);
+                mapping_size_ = std::exchange(other.mapping_size_, 0);
+                data_ = std::exchange(other.data_, {});
+            }
+            return *this;
+        }
+
+        ~MappedDataset()
+        {
+            unmap();
+        }
+
+        std::span<const T> data() const { return data_; }
+        operator std::span<const T>() const { return data_; }
+
+        auto begin() const { return data_.begin(); }
+        auto end() const { return data_.end(); }
+        size_t size() const { return data_.size(); }
+        const T& operator[](size_t index) const { return data_[index]; }
+
+    private:
+        void* mapping_;
+        size_t mapping_size_;
+        std::span<const T> data_;
+
+        void unmap()
+        {
+            if (mapping_)
+                ::munmap(mapping_, mapping_size_);
+        }
+    };
+
+    // persists generated datasets as versioned binary files: <directory>/dataset-<key hash>.bin
+    // - header (magic, version, element size, count & type, checksum, full key) padded to 4 KiB, followed by raw data
+    // - files are written to a temporary name and renamed, so readers never see partial data
+    class DatasetCache
+    {
+    public:
+        explicit DatasetCache(std::filesystem::path directory)
+            : directory_{std::move(directory)}
+        {
+            std::filesystem::create_directories(directory_);
+        }
+
+        const std::filesystem::path& directory() const { return directory_; }
+
+        std::filesystem::path file_path(const DatasetKey& key) const
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "dataset-%016llx.bin", static_cast<unsigned long long>(detail::hash_bytes(key.to_string())));
+            return directory_ / name;
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        std::optional<MappedDataset<T>> find(const DatasetKey& key, Validation validation = Validation::checksum) const
+        {
+            const auto path = file_path(key);
+
+            detail::FileDescriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (file.get() == -1)
+                return std::nullopt;
+
+            struct stat file_stat;
+            if (::fstat(file.get(), &file_stat) == -1)
+                detail::throw_errno("fstat " + path.string());
+
+            const auto file_size = static_cast<size_t>(file_stat.st_size);
+            if (file_size < detail::FileHeader::data_offset)
+                return std::nullopt;
+
+            void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file.get(), 0);
+            if (mapping == MAP_FAILED)
+                detail::throw_errno("mmap " + path.string());
+
+            const auto* header = static_cast<const detail::FileHeader*>(mapping);
+            const auto key_text = key.to_string();
+            MappedDataset<T> dataset{mapping, file_size, header->element_count};
+
+            // element_count comes from the file - dividing avoids overflowing element_count * sizeof(T)
+            const bool header_valid = std::memcmp(header->magic, detail::FileHeader::expected_magic, sizeof(header->magic)) == 0
+                && header->version == detail::FileHeader::current_version
+                && header->element_size == sizeof(T)
+                && header->element_type == detail::element_type_of<T>()
+                && header->element_count == key.size
+                && (file_size - detail::FileHeader::data_offset) % sizeof(T) == 0
+                && header->element_count == (file_size - detail::FileHeader::data_offset) / sizeof(T)
+                && std::string_view{header->key, std::min<size_t>(header->key_length, sizeof(header->key))} == key_text;
+
+            if (!header_valid)
+                return std::nullopt;
+
+            if (validation == Validation::checksum && detail::checksum(std::as_bytes(dataset.data())) != header->checksum)
+                return std::nullopt;
+
+            return dataset;
+        }
+
+        // generate(std::span<T>) fills the memory of the new cache file directly
+        template <typename T, std::invocable<std::span<T>> TGenerator>
+            requires std::is_trivially_copyable_v<T>
+        MappedDataset<T> get_or_create(const DatasetKey& key, TGenerator&& generate, Validation validation = Validation::checksum)
+        {
+            if (auto cached = find<T>(key, validation))
+                return std::move(*cached);
+
+            store<T>(key, std::forward<TGenerator>(generate));
+
+            auto created = find<T>(key, Validation::header_only);
+            if (!created)
+                throw std::runtime_error("Dataset cache file cannot be read back: " + file_path(key).string());
+
+            return std::move(*created);
+        }
+
+        // uniformly distributed ints in [low; high) - see helpers::fill_numeric_dataset
+        MappedDataset<int> get_numeric_dataset(size_t size, uint32_t seed = 42, int low = -100, int high = 100, Validation validation = Validation::checksum)
+        {
+            DatasetKey key{.engine = "pcg32", .seed = seed, .size = size, .low = low, .high = high, .distribution = "uniform_int"};
+
+            return get_or_create<int>(key, [&](std::span<int> data) { fill_numeric_dataset(data, seed, low, high); }, validation);
+        }
+
+    private:
+        std::filesystem::path directory_;
+
+        template <typename T, typename TGenerator>
+        void store(const DatasetKey& key, TGenerator&& generate)
+        {
+            const auto key_text = key.to_string();
+            if (key_text.size() > sizeof(detail::FileHeader::key))
+                throw std::length_error("Dataset key is too long: " + key_text);
+
+            if (key.size > (std::numeric_limits<size_t>::max() - detail::FileHeader::data_offset) / sizeof(T))
+                throw std::length_error("Dataset is too large: " + key_text);
+
+            const size_t file_size = detail::FileHeader::data_offset + key.size * sizeof(T);
+            const auto path = file_path(key);
+
+            // mkstemp picks a name no other thread or process is writing to
+            std::string temp_name = path.string() + ".tmp.XXXXXX";
+            detail::FileDescriptor file{::mkstemp(temp_name.data())};
+            if (file.get() == -1)
+                detail::throw_errno("mkstemp " + temp_name);
+
+            const std::filesystem::path temp_path{temp_name};
+
+            try
+            {
+                if (::fchmod(file.get(), 0644) == -1)
+                    detail::throw_errno("fchmod " + temp_name);
+
+                if (::ftruncate(file.get(), static_cast<off_t>(file_size)) == -1)
+                    detail::throw_errno("ftruncate " + temp_name);
+
+                void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, file.get(), 0);
+                if (mapping == MAP_FAILED)
+                    detail::throw_errno("mmap " + temp_name);
+
+                auto* header = static_cast<detail::FileHeader*>(mapping);
+                std::span<T> data{reinterpret_cast<T*>(static_cast<std::byte*>(mapping) + detail::FileHeader::data_offset), key.size};
+
+                try
+                {
+                    generate(data);
+                }
+                catch (...)
+                {
+                    ::munmap(mapping, file_size);
+                    throw;
+                }
+
+                std::memcpy(header->magic, detail::FileHeader::expected_magic, sizeof(header->magic));
+                header->version = detail::FileHeader::current_version;
+                header->element_size = sizeof(T);
+                header->element_type = detail::element_type_of<T>();
+                header->element_count = key.size;
+                header->checksum = detail::checksum(std::as_bytes(data));
+                header->key_length = static_cast<std::uint32_t>(key_text.size());
+                std::memcpy(header->key, key_text.data(), key_text.size());
+
+                ::munmap(mapping, file_size);
+
+                std::filesystem::rename(temp_path, path);
+            }
+            catch (...)
+            {
+                std::error_code ignored;
+                std::filesystem::remove(temp_path, ignored);
+                throw;
+            }
+        }
+    };
+} // namespace helpers::cache
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef DISTRIBUTIONS_HPP
+#define DISTRIBUTIONS_HPP
+
+#include "random.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace helpers::random
+{
+    // engines producing uniformly distributed 32-bit values - PCG, MultiStreamPCG, std::mt19937
+    template <typename TEngine>
+    concept Engine32 = std::uniform_random_bit_generator<std::remove_reference_t<TEngine>>
+        && (std::remove_reference_t<TEngine>::min() == 0)
+        && (std::remove_reference_t<TEngine>::max() == std::numeric_limits<std::uint32_t>::max());
+
+    template <typename TDistribution, typename TEngine = PCG>
+    concept Distribution = requires(TDistribution distr, TEngine& rng) {
+        typename TDistribution::result_type;
+        { distr(rng) } -> std::convertible_to<typename TDistribution::result_type>;
+    };
+
+    namespace detail
+    {
+        // constexpr math - used both at compile time and at runtime, so that datasets are identical
+        // - requires -ffp-contract=off (set by the helpers target), otherwise runtime code may use FMA
+
+        constexpr double sqrt(double x)
+        {
+            if (x <= 0.0 || x == std::numeric_limits<double>::infinity())
+                return x == 0.0 || x == std::numeric_limits<double>::infinity() ? x : std::numeric_limits<double>::quiet_NaN();
+
+            double guess = x > 1.0 ? x : 1.0;
+            for (int i = 0; i < 1100; ++i)
+            {
+                double next = 0.5 * (guess + x / guess);
+                if (next >= guess)
+                    break;
+                guess = next;
+            }
+
+            return guess;
+        }
+
+        constexpr double log(double x)
+        {
+            if (x <= 0.0)
+                return x == 0.0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+            if (x == std::numeric_limits<double>::infinity())
+                return x;
+
+            int exponent = 0;
+            while (x < 1.0 / 1024)
+            {
+                x *= 1024;
+                exponent -= 10;
+            }
+
+            // x = mantissa * 2^exponent, mantissa in [sqrt(2)/2; sqrt(2))
+            auto bits = std::bit_cast<std::uint64_t>(x);
+            exponent += static_cast<int>((bits >> 52) & 0x7FF) - 1023;
+            double mantissa = std::bit_cast<double>((bits & 0x000F'FFFF'FFFF'FFFFULL) | 0x3FF0'0000'0000'0000ULL);
+            if (mantissa > std::numbers::sqrt2)
+            {
+                mantissa /= 2.0;
+                ++exponent;
+            }
+
+            // log(m) = 2 * atanh((m - 1) / (m + 1))
+            const double t = (mantissa - 1.0) / (mantissa + 1.0);
+            const double t2 = t * t;
+            double term = t;
+            double sum = 0.0;
+            for (int k = 1; k < 40; k += 2)
+            {
+                sum += term / k;
+                term *= t2;
+            }
+
+            return exponent * std::numbers::ln2 + 2.0 * sum;
+        }
+
+        constexpr double exp(double x)
+        {
+            if (x != x)
+                return x;
+            if (x > 709.0)
+                return std::numeric_limits<double>::infinity();
+            if (x < -708.0)
+                return 0.0;
+
+            // exp(x) = 2^k * exp(r), |r| <= ln(2) / 2
+            const auto k = static_cast<std::int64_t>(x / std::numbers::ln2 + (x < 0 ? -0.5 : 0.5));
+            const double r = x - k * std::numbers::ln2;
+
+            double term = 1.0;
+            double sum = 1.0;
+            for (int n = 1; n < 25; ++n)
+            {
+                term *= r / n;
+                sum += term;
+            }
+
+            return sum * std::bit_cast<double>(static_cast<std::uint64_t>(k + 1023) << 52);
+        }
+
+        // log1p(x) / x
+        constexpr double log1p_div_x(double x)
+        {
+            if (x > 1e-8 || x < -1e-8)
+                return log(1.0 + x) / x;
+            return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+        }
+
+        // expm1(x) / x
+        constexpr double expm1_div_x(double x)
+        {
+            if (x > 1e-8 || x < -1e-8)
+                return (exp(x) - 1.0) / x;
+            return 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+        }
+
+        // uniform in [0; 1) with full mantissa precision
+        template <std::floating_point T>
+        constexpr T generate_canonical(Engine32 auto& rng)
+        {
+            if constexpr (std::numeric_limits<T>::digits <= 32)
+            {
+                return static_cast<T>(rng() >> (32 - std::numeric_limits<T>::digits)) * (T{1} / (std::uint64_t{1} << std::numeric_limits<T>::digits));
+            }
+            else
+            {
+                std::uint64_t bits = (std::uint64_t{rng()} << 32) | rng();
+                return static_cast<T>(bits >> 11) * 0x1.0p-53;
+            }
+        }
+    } // namespace detail
+
+    // uniform integers in closed range [a; b]
+    // D. Lemire, "Fast Random Integer Generation in an Interval" - a multiply and a shift,
+    // division only for the rare rejection threshold, no modulo bias
+    template <std::integral T = int>
+        requires(sizeof(T) <= sizeof(std::uint32_t))
+    struct uniform_int_distribution
+    {
+        using result_type = T;
+
+        T a = 0;
+        T b = std::numeric_limits<T>::max();
+
+        constexpr result_type operator()(Engine32 auto& rng) const
+        {
+            const std::uint32_t range = static_cast<std::uint32_t>(static_cast<std::uint32_t>(b) - static_cast<std::uint32_t>(a)) + 1;
+
+            if (range == 0) // full 32-bit range
+                return static_cast<T>(rng());
+
+            std::uint64_t product = std::uint64_t{rng()} * range;
+            auto low_bits = static_cast<std::uint32_t>(product);
+
+            if (low_bits < range)
+            {
+                const std::uint32_t threshold = -range % range;
+                while (low_bits < threshold)
+                {
+                    product = std::uint64_t{rng()} * range;
+                    low_bits = static_cast<std::uint32_t>(product);
+                }
+            }
+
+            return static_cast<T>(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(product >> 32));
+        }
+    };
+
+    // uniform floating point values in half-open range [a; b)
+    template <std::floating_point T = double>
+    struct uniform_real_distribution
+    {
+        using result_type = T;
+
+        T a = 0;
+        T b = 1;
+
+        constexpr result_type operator()(Engine32 auto& rng) const
+        {
+            return a + (b - a) * detail::generate_canonical<T>(rng);
+        }
+    };
+
+    // Marsaglia polar method - the second value of each pair is cached
+    template <std::floating_point T = double>
+    struct normal_distribution
+    {
+        using result_type = T;
+
+        T mean;
+        T stddev;
+
+        constexpr explicit normal_distribution(T mean = 0, T stddev = 1)
+            : mean{mean}
+            , stddev{stddev}
+        {
+        }
+
+        constexpr result_type operator()(Engine32 auto& rng)
+        {
+            if (has_cached_)
+            {
+                has_cached_ = false;
+                return mean + stddev * cached_;
+            }
+
+            double u, v, s;
+            do
+            {
+                u = 2.0 * detail::generate_canonical<double>(rng) - 1.0;
+                v = 2.0 * detail::generate_canonical<double>(rng) - 1.0;
+                s = u * u + v * v;
+            } while (s >= 1.0 || s == 0.0);
+
+            const double factor = detail::sqrt(-2.0 * detail::log(s) / s);
+
+            cached_ = static_cast<T>(v * factor);
+            has_cached_ = true;
+
+            return mean + stddev * static_cast<T>(u * factor);
+        }
+
+    private:
+        T cached_{};
+        bool has_cached_ = false;
+    };
+
+    // values 1..n with P(k) ~ 1 / k^s
+    // W. Hormann, G. Derflinger, "Rejection-inversion to generate variates from monotone discrete distributions"
+    template <std::integral T = int>
+    class zipf_distribution
+    {
+    public:
+        using result_type = T;
+
+        constexpr zipf_distribution(T n, double s = 1.0)
+            : n_{n}
+            , s_{s}
+            , h_integral_x1_{h_integral(1.5) - 1.0}
+            , h_integral_n_{h_integral(n + 0.5)}
+            , threshold_{2.0 - h_integral_inverse(h_integral(2.5) - h(2.0))}
+        {
+        }
+
+        constexpr result_type operator()(Engine32 auto& rng) const
+        {
+            while (true)
+            {
+                const double u = h_integral_n_ + detail::generate_canonical<double>(rng) * (h_integral_x1_ - h_integral_n_);
+                const double x = h_integral_inverse(u);
+                const double k = std::clamp(static_cast<double>(static_cast<std::int64_t>(x + 0.5)), 1.0, static_cast<double>(n_));
+
+                if (k - x <= threshold_ || u >= h_integral(k + 0.5) - h(k))
+                    return static_cast<T>(k);
+            }
+        }
+
+        constexpr T n() const { return n_; }
+        constexpr double s() const { return s_; }
+
+    private:
+        T n_;
+        double s_;
+        double h_integral_x1_;
+        double h_integral_n_;
+        double threshold_;
+
+        constexpr double h(double x) const
+        {
+            return detail::exp(-s_ * detail::log(x));
+        }
+
+        constexpr double h_integral(double x) const
+        {
+            const double log_x = detail::log(x);
+            return detail::expm1_div_x((1.0 - s_) * log_x) * log_x;
+        }
+
+        constexpr double h_integral_inverse(double x) const
+        {
+            const double t = std::max(x * (1.0 - s_), -1.0);
+            return detail::exp(detail::log1p_div_x(t) * x);
+        }
+    };
+
+    // layouts of benchmark inputs - applied on top of generated values
+    enum class Pattern
+    {
+        random,
+        sorted,
+        reversed,
+        nearly_sorted, // sorted with 1% of elements swapped
+        few_unique     // only 16 distinct values
+    };
+
+    template <std::ranges::random_access_range TRange>
+    constexpr void apply_pattern(TRange&& data, Pattern pattern, std::uint32_t seed = 42)
+    {
+        PCG rng{seed, 0xDA7A};
+
+        auto random_index = [&rng, size = std::ranges::size(data)] {
+            return uniform_int_distribution<std::uint32_t>{0, static_cast<std::uint32_t>(size - 1)}(rng);
+        };
+
+        if (std::ranges::empty(data))
+            return;
+
+        switch (pattern)
+        {
+        case Pattern::random:
+            break;
+        case Pattern::sorted:
+            std::ranges::sort(data);
+            break;
+        case Pattern::reversed:
+            std::ranges::sort(data, std::greater{});
+            break;
+        case Pattern::nearly_sorted:
+            std::ranges::sort(data);
+            for (size_t i = 0; i < std::ranges::size(data) / 100; ++i)
+                std::ranges::swap(data[random_index()], data[random_index()]);
+            break;
+        case Pattern::few_unique:
+        {
+            std::array<std::ranges::range_value_t<TRange>, 16> pool{};
+            std::ranges::generate(pool, [&] { return data[random_index()]; });
+            std::ranges::generate(data, [&] { return pool[uniform_int_distribution<std::uint32_t>{0, pool.size() - 1}(rng)]; });
+            break;
+        }
+        }
+    }
+} // namespace helpers::random
+
+#endif
@@ -0,0 +1,467 @@
+#ifndef EXPORT_HPP
+#define EXPORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace helpers::exporting
+{
+    // writes to a file descriptor in large, page aligned blocks
+    class BlockWriter
+    {
+    public:
+        static constexpr size_t block_alignment = 4096;
+        static constexpr size_t default_block_size = 1024 * 1024;
+
+        explicit BlockWriter(int fd, size_t block_size = default_block_size)
+            : fd_{fd}
+            , block_size_{(block_size + block_alignment - 1) / block_alignment * block_alignment}
+            , buffer_{static_cast<char*>(std::aligned_alloc(block_alignment, block_size_))}
+        {
+            if (!buffer_)
+                throw std::bad_alloc{};
+        }
+
+        explicit BlockWriter(const char* path, size_t block_size = default_block_size)
+            : BlockWriter{::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644), block_size}
+        {
+            if (fd_ == -1)
+                throw std::system_error(errno, std::generic_category(), std::string{"open "} + path);
+            owns_fd_ = true;
+        }
+
+        BlockWriter(const BlockWriter&) = delete;
+        BlockWriter& operator=(const BlockWriter&) = delete;
+
+        ~BlockWriter()
+        {
+            try
+            {
+                flush();
+            }
+            catch (...)
+            { }
+
+            if (owns_fd_)
+                ::close(fd_);
+        }
+
+        void write(std::string_view bytes)
+        {
+            while (!bytes.empty())
+            {
+                if (size_ == block_size_)
+                    flush();
+
+                const size_t chunk = std::min(bytes.size(), block_size_ - size_);
+                std::memcpy(buffer_.get() + size_, bytes.data(), chunk);
+                size_ += chunk;
+                bytes.remove_prefix(chunk);
+            }
+        }
+
+        void write(char c)
+        {
+            if (size_ == block_size_)
+                flush();
+            buffer_[size_++] = c;
+        }
+
+        void write_bytes(std::span<const std::byte> bytes)
+        {
+            write(std::string_view{reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+        }
+
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void write_raw(const T& value)
+        {
+            write_bytes(std::as_bytes(std::span{&value, 1}));
+        }
+
+        // formats directly into the block - no temporary strings
+        // - near the end of the block the value is formatted on the stack and split across the boundary,
+        //   so every flushed block stays full
+        template <typename T>
+        void write_chars(const T& value)
+        {
+            constexpr size_t max_chars = 64; // enough for every arithmetic type in the shortest representation
+
+            if (block_size_ - size_ >= max_chars)
+            {
+                const auto [end, error] = std::to_chars(buffer_.get() + size_, buffer_.get() + block_size_, value);
+                if (error != std::errc{})
+                    throw std::system_error(std::make_error_code(error), "to_chars");
+                size_ = static_cast<size_t>(end - buffer_.get());
+                return;
+            }
+
+            char chars[max_chars];
+            const auto [end, error] = std::to_chars(std::begin(chars), std::end(chars), value);
+            if (error != std::errc{})
+                throw std::system_error(std::make_error_code(error), "to_chars");
+            write(std::string_view{chars, end});
+        }
+
+        void flush()
+        {
+            for (size_t pos = 0; pos < size_;)
+            {
+                const auto written = ::write(fd_, buffer_.get() + pos, size_ - pos);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::system_error(errno, std::generic_category(), "write");
+                }
+                pos += static_cast<size_t>(written);
+            }
+
+            size_ = 0;
+        }
+
+    private:
+        struct FreeDeleter
+        {
+            void operator()(char* ptr) const { std::free(ptr); }
+        };
+
+        int fd_;
+        bool owns_fd_ = false;
+        size_t block_size_;
+        std::unique_ptr<char[], FreeDeleter> buffer_;
+        size_t size_ = 0;
+    };
+
+    template <typename T>
+    concept StringField = std::convertible_to<const T&, std::string_view>;
+
+    template <typename T>
+    concept ScalarField = std::is_arithmetic_v<T> || StringField<T>;
+
+    template <typename T>
+    concept TupleLike = requires { std::tuple_size<T>::value; };
+
+    // aggregates are exported through an ADL-found export_fields returning a tuple of their fields:
+    //   auto export_fields(const Person& p) { return std::tie(p.name, p.age); }
+    template <typename T>
+    concept HasExportFields = requires(const T& record) {
+        { export_fields(record) } -> TupleLike;
+    };
+
+    template <typename T>
+    concept ExportableRecord = ScalarField<T> || TupleLike<T> || HasExportFields<T>;
+
+    template <typename T>
+    concept ExportableRange = std::ranges::input_range<T> && ExportableRecord<std::remove_cvref_t<std::ranges::range_reference_t<T>>>;
+
+    namespace detail
+    {
+        template <typename T>
+        decltype(auto) fields_of(const T& record)
+        {
+            if constexpr (HasExportFields<T>)
+                return export_fields(record);
+            else if constexpr (TupleLike<T>)
+                return (record);
+            else
+                return std::tie(record);
+        }
+
+        template <typename TRecord>
+        using fields_t = std::remove_cvref_t<decltype(fields_of(std::declval<const TRecord&>()))>;
+
+        template <typename TField>
+        void write_csv_field(BlockWriter& out, const TField& field)
+        {
+            if constexpr (StringField<TField>)
+            {
+                const std::string_view text{field};
+
+                if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+                {
+                    out.write(text);
+                    return;
+                }
+
+                out.write('"');
+                for (char c : text)
+                {
+                    if (c == '"')
+                        out.write('"');
+                    out.write(c);
+                }
+                out.write('"');
+            }
+            else if constexpr (std::same_as<TField, bool>)
+            {
+                out.write(field ? '1' : '0');
+            }
+            else
+            {
+                out.write_chars(field);
+            }
+        }
+
+        inline void write_json_string(BlockWriter& out, std::string_view text)
+        {
+            constexpr char hex_digits[] = "0123456789abcdef";
+
+            out.write('"');
+            for (char c : text)
+            {
+                switch (c)
+                {
+                case '"':
+                    out.write("\\\"");
+                    break;
+                case '\\':
+                    out.write("\\\\");
+                    break;
+                case '\n':
+                    out.write("\\n");
+                    break;
+                case '\r':
+                    out.write("\\r");
+                    break;
+                case '\t':
+                    out.write("\\t");
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        out.write("\\u00");
+                        out.write(hex_digits[(c >> 4) & 0xF]);
+                        out.write(hex_digits[c & 0xF]);
+                    }
+                    else
+                    {
+                        out.write(c);
+                    }
+                }
+            }
+            out.write('"');
+        }
+
+        template <typename TField>
+        void write_json_field(BlockWriter& out, const TField& field)
+        {
+            if constexpr (StringField<TField>)
+                write_json_string(out, std::string_view{field});
+            else if constexpr (std::same_as<TField, bool>)
+                out.write(field ? "true" : "false");
+            else if constexpr (std::floating_point<TField>)
+            {
+                if (std::isfinite(field))
+                    out.write_chars(field);
+                else
+                    out.write("null");
+            }
+            else
+                out.write_chars(field);
+        }
+
+        // binary columnar format
+        enum class ColumnType : std::uint8_t
+        {
+            int8 = 1, int16, int32, int64,
+            uint8, uint16, uint32, uint64,
+            float32, float64,
+            string
+        };
+
+        template <typename TField>
+        concept ColumnField = StringField<TField> || std::same_as<TField, float> || std::same_as<TField, double>
+            || (std::integral<TField> && (sizeof(TField) == 1 || sizeof(TField) == 2 || sizeof(TField) == 4 || sizeof(TField) == 8));
+
+        template <typename TField>
+        constexpr ColumnType column_type()
+        {
+            static_assert(ColumnField<TField>, "binary columns hold strings, float, double and 1, 2, 4 or 8 byte integers");
+
+            if constexpr (StringField<TField>)
+                return ColumnType::string;
+            else if constexpr (std::floating_point<TField>)
+                return sizeof(TField) == 4 ? ColumnType::float32 : ColumnType::float64;
+            else
+            {
+                constexpr auto width_index = std::bit_width(sizeof(TField)) - 1; // 1, 2, 4, 8 bytes -> 0..3
+                return static_cast<ColumnType>((std::is_signed_v<TField> ? 1 : 5) + width_index);
+            }
+        }
+
+        template <typename TField>
+        struct ColumnBuffer
+        {
+            std::vector<TField> values;
+
+            void add(const TField& value) { values.push_back(value); }
+
+            void write_to(BlockWriter& out)
+            {
+                out.write_bytes(std::as_bytes(std::span{values}));
+                values.clear();
+            }
+        };
+
+        template <StringField TField>
+        struct ColumnBuffer<TField>
+        {
+            std::vector<std::uint32_t> lengths;
+            std::string bytes;
+
+            void add(const TField& value)
+            {
+                const std::string_view text{value};
+                lengths.push_back(static_cast<std::uint32_t>(text.size()));
+                bytes.append(text);
+            }
+
+            void write_to(BlockWriter& out)
+            {
+                out.write_bytes(std::as_bytes(std::span{lengths}));
+                out.write(bytes);
+                lengths.clear();
+                bytes.clear();
+            }
+        };
+    } // namespace detail
+
+    // one line per record - fields separated with commas, strings quoted only when needed (RFC 4180)
+    template <ExportableRange TRange>
+    void export_csv(BlockWriter& out, TRange&& rng, std::initializer_list<std::string_view> column_names = {})
+    {
+        if (column_names.size() > 0)
+        {
+            bool first = true;
+            for (auto name : column_names)
+            {
+                if (!std::exchange(first, false))
+                    out.write(',');
+                detail::write_csv_field(out, name);
+            }
+            out.write('\n');
+        }
+
+        for (const auto& record : rng)
+        {
+            std::apply([&](const auto&... fields) {
+                bool first = true;
+                ((std::exchange(first, false) ? void() : out.write(','), detail::write_csv_field(out, fields)), ...);
+            }, detail::fields_of(record));
+            out.write('\n');
+        }
+    }
+
+    // one JSON value per line - an object when column names are given, an array (or a scalar) otherwise
+    template <ExportableRange TRange>
+    void export_json_lines(BlockWriter& out, TRange&& rng, std::initializer_list<std::string_view> column_names = {})
+    {
+        using TRecord = std::remove_cvref_t<std::ranges::range_reference_t<TRange>>;
+        constexpr size_t field_count = std::tuple_size_v<detail::fields_t<TRecord>>;
+
+        if (column_names.size() != 0 && column_names.size() != field_count)
+            throw std::invalid_argument("export_json_lines: number of column names does not match number of fields");
+
+        for (const auto& record : rng)
+        {
+            std::apply([&](const auto&... fields) {
+                if (column_names.size() != 0)
+                {
+                    auto name = column_names.begin();
+                    out.write('{');
+                    bool first = true;
+                    ((std::exchange(first, false) ? void() : out.write(','), detail::write_json_string(out, *name++), out.write(':'), detail::write_json_field(out, fields)), ...);
+                    out.write('}');
+                }
+                else if constexpr (ScalarField<TRecord>)
+                {
+                    (detail::write_json_field(out, fields), ...);
+                }
+                else
+                {
+                    out.write('[');
+                    bool first = true;
+                    ((std::exchange(first, false) ? void() : out.write(','), detail::write_json_field(out, fields)), ...);
+                    out.write(']');
+                }
+            }, detail::fields_of(record));
+            out.write('\n');
+        }
+    }
+
+    // raw binary columnar format (native byte order and layout - a reader on a host of the other endianness has to swap):
+    //   "HLPCOL1\0" | u32 column count | u8 column type per column |
+    //   row groups: u32 row count, then every column: fixed-width values or (u32 lengths[rows], bytes) for strings |
+    //   u32 0 as terminator
+    // fields: 1, 2, 4 or 8 byte integers, float, double and strings
+    // only one row group is kept in memory, row_group_size has to fit the u32 row count
+    template <ExportableRange TRange>
+    void export_binary_columnar(BlockWriter& out, TRange&& rng, size_t row_group_size = 64 * 1024)
+    {
+        if (row_group_size == 0 || row_group_size > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("export_binary_columnar: row_group_size must be in [1; UINT32_MAX]");
+
+        using TRecord = std::remove_cvref_t<std::ranges::range_reference_t<TRange>>;
+        using TFields = detail::fields_t<TRecord>;
+
+        auto columns = [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return std::tuple<detail::ColumnBuffer<std::remove_cvref_t<std::tuple_element_t<Is, TFields>>>...>{};
+        }(std::make_index_sequence<std::tuple_size_v<TFields>>{});
+
+        out.write(std::string_view{"HLPCOL1\0", 8});
+        out.write_raw(static_cast<std::uint32_t>(std::tuple_size_v<TFields>));
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (out.write_raw(detail::column_type<std::remove_cvref_t<std::tuple_element_t<Is, TFields>>>()), ...);
+        }(std::make_index_sequence<std::tuple_size_v<TFields>>{});
+
+        std::uint32_t rows = 0;
+
+        auto write_row_group = [&] {
+            out.write_raw(rows);
+            std::apply([&](auto&... column) { (column.write_to(out), ...); }, columns);
+            rows = 0;
+        };
+
+        for (const auto& record : rng)
+        {
+            std::apply([&](const auto&... fields) {
+                std::apply([&](auto&... column) { (column.add(fields), ...); }, columns);
+            }, detail::fields_of(record));
+
+            if (++rows == row_group_size)
+                write_row_group();
+        }
+
+        if (rows > 0)
+            write_row_group();
+
+        out.write_raw(std::uint32_t{0});
+    }
+} // namespace helpers::exporting
+
+#endif
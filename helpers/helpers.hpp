@@ -1,65 +1,316 @@
 #ifndef HELPERS_HPP
 #define HELPERS_HPP
 
+#include "distributions.hpp"
 #include "random.hpp"
 
 #include <iostream>
-#include <random>
 #include <ranges>
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
+#include <cerrno>
 #include <cstdint>
 
+#include <unistd.h>
+
 namespace helpers
 {
     template <typename T>
     concept PrintableRange = std::ranges::range<T> && requires(std::ranges::range_value_t<T>&& item) { std::cout << item; };
 
-    void print(PrintableRange auto&& rng, std::string_view prefix = "rng")
+    struct PrintOptions
     {
-        std::cout << prefix << " = [";
-        for (const auto& item : rng)
+        std::string_view separator = " "; // written after every item
+        size_t limit = std::numeric_limits<size_t>::max(); // items above the limit are replaced with "..."
+        int fd = -1; // -1 - std::cout, otherwise written directly to the file descriptor
+    };
+
+    namespace detail
+    {
+        // reusable per-thread buffer - items are formatted in memory and written in large chunks
+        // - a print called from an item's operator<< gets its own buffer, the output of the outer print
+        //   is flushed first, so the order of the output is kept
+        class PrintBuffer
         {
-            if constexpr (std::convertible_to<decltype(item), std::string_view>)
+        public:
+            static constexpr size_t flush_threshold = 64 * 1024;
+
+            explicit PrintBuffer(int fd)
+                : fd_{fd}
+                , outer_{std::exchange(active(), this)}
+                , buffer_{outer_ ? own_buffer_ : thread_buffer()}
+            {
+                if (outer_)
+                    outer_->flush();
+                else
+                    buffer_.clear();
+            }
+
+            PrintBuffer(const PrintBuffer&) = delete;
+            PrintBuffer& operator=(const PrintBuffer&) = delete;
+
+            ~PrintBuffer()
+            {
+                flush();
+                active() = outer_;
+            }
+
+            void append(std::string_view text)
+            {
+                buffer_.append(text);
+                flush_if_full();
+            }
+
+            void append(char c)
             {
-                std::cout << '"' << item << '"' << " ";
+                buffer_.push_back(c);
+                flush_if_full();
             }
-            else
+
+            template <typename T>
+            void append_item(const T& item)
+            {
+                if constexpr (std::convertible_to<const T&, std::string_view>)
+                {
+                    append('"');
+                    append(std::string_view{item});
+                    append('"');
+                }
+                else if constexpr (std::integral<T> && sizeof(T) == 1) // bool and characters - as printed by ostream
+                {
+                    append_streamed(item);
+                }
+                else if constexpr (std::integral<T>)
+                {
+                    append_chars(item);
+                }
+                else if constexpr (std::floating_point<T>)
+                {
+                    append_chars(item, std::chars_format::general, 6); // the same as default ostream precision
+                }
+                else
+                {
+                    append_streamed(item);
+                }
+            }
+
+            void flush()
+            {
+                if (buffer_.empty())
+                    return;
+
+                if (fd_ == -1)
+                {
+                    std::cout.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                }
+                else
+                {
+                    if (fd_ == STDOUT_FILENO)
+                        std::cout.flush(); // keeps ordering with output already buffered in std::cout
+
+                    for (std::string_view pending = buffer_; !pending.empty();)
+                    {
+                        const auto written = ::write(fd_, pending.data(), pending.size());
+                        if (written < 0)
+                        {
+                            if (errno == EINTR)
+                                continue;
+                            break;
+                        }
+                        pending.remove_prefix(static_cast<size_t>(written));
+                    }
+                }
+
+                buffer_.clear();
+            }
+
+        private:
+            int fd_;
+            PrintBuffer* outer_;
+            std::string own_buffer_;
+            std::string& buffer_;
+
+            static PrintBuffer*& active()
+            {
+                thread_local PrintBuffer* active = nullptr;
+                return active;
+            }
+
+            static std::string& thread_buffer()
+            {
+                thread_local std::string buffer = [] {
+                    std::string buffer;
+                    buffer.reserve(flush_threshold + 4096);
+                    return buffer;
+                }();
+
+                return buffer;
+            }
+
+            void flush_if_full()
+            {
+                if (buffer_.size() >= flush_threshold)
+                    flush();
+            }
+
+            template <typename T, typename... TFormat>
+            void append_chars(const T& value, TFormat... format)
+            {
+                char chars[64];
+                const auto [end, error] = std::to_chars(std::begin(chars), std::end(chars), value, format...);
+                append(std::string_view{chars, end});
+            }
+
+            template <typename T>
+            void append_streamed(const T& item)
+            {
+                if (outer_) // the outer print is in the middle of streaming into the shared stream
+                {
+                    std::ostringstream out;
+                    out << item;
+                    append(out.view());
+                    return;
+                }
+
+                thread_local std::ostringstream out;
+                out.str({});
+                out << item;
+                append(out.view());
+            }
+        };
+    } // namespace detail
+
+    // items are formatted by the library, not by std::cout
+    // - numbers use std::to_chars (floating point as with the default precision of 6), so the formatting state
+    //   of std::cout (precision, std::hex, std::boolalpha, ...) is ignored
+    // - strings are quoted, other items are written with their operator<< to a stream in the default state
+    void print(PrintableRange auto&& rng, std::string_view prefix = "rng", const PrintOptions& options = {})
+    {
+        detail::PrintBuffer out{options.fd};
+
+        out.append(prefix);
+        out.append(" = [");
+
+        size_t count = 0;
+        for (const auto& item : rng)
+        {
+            if (count++ == options.limit)
             {
-                std::cout << item << " ";
+                out.append("...");
+                out.append(options.separator);
+                break;
             }
+
+            out.append_item(item);
+            out.append(options.separator);
         }
-        std::cout << "]\n";
+
+        out.append("]\n");
     }
 
-    template <size_t Size>
-    [[nodiscard]] constexpr auto create_numeric_dataset(uint32_t seed = 42, int low = -100, int high = 100)
+    namespace detail
+    {
+        template <typename TDistribution>
+        constexpr void fill_dataset_block(std::span<typename TDistribution::result_type> block, uint32_t seed, uint64_t block_index, TDistribution distr)
+        {
+            random::PCG pcg_rnd{seed, block_index};
+
+            std::ranges::generate(block, [&] { return distr(pcg_rnd); });
+        }
+    } // namespace detail
+
+    // block b of every dataset is generated from PCG{seed, b}
+    // - the same values at compile time and at runtime, regardless of the number of threads
+    inline constexpr size_t dataset_block_size = 64 * 1024;
+
+    // thread_count == 0 - use all hardware threads
+    template <random::Distribution TDistribution>
+    constexpr void fill_dataset(std::span<typename TDistribution::result_type> data, uint32_t seed, TDistribution distr, size_t thread_count = 0)
     {
-        std::vector<int> data(Size);
-        data.reserve(Size);
+        const size_t block_count = (data.size() + dataset_block_size - 1) / dataset_block_size;
 
-        auto uniform_distr = [low, high](auto&& rnd_gen) {
-            uint32_t width = high - low;
-            return (rnd_gen() % width) + low;
+        auto fill_blocks = [=](size_t first_block, size_t last_block) {
+            for (size_t block = first_block; block < last_block; ++block)
+            {
+                const size_t offset = block * dataset_block_size;
+                detail::fill_dataset_block(data.subspan(offset, std::min(dataset_block_size, data.size() - offset)), seed, block, distr);
+            }
         };
 
-        if (std::is_constant_evaluated())
+        if (std::is_constant_evaluated() || block_count < 2)
         {
-            random::PCG pcg_rnd{seed};
-
-            std::ranges::generate(data, [&] { return uniform_distr(pcg_rnd); });
+            fill_blocks(0, block_count);
+            return;
         }
-        else
-        {
-            std::mt19937 mt_rnd{seed};
 
-            std::ranges::generate(data, [&] { return uniform_distr(mt_rnd); });
+        if (thread_count == 0)
+            thread_count = std::thread::hardware_concurrency();
+        thread_count = std::clamp<size_t>(std::min(thread_count, block_count), 1, 256);
+
+        if (thread_count == 1)
+        {
+            fill_blocks(0, block_count);
+            return;
         }
 
-        std::array<int, Size> result_data{};
-        std::ranges::copy(data, result_data.begin());
+        std::vector<std::jthread> workers;
+        workers.reserve(thread_count);
+
+        for (size_t worker = 0; worker < thread_count; ++worker)
+            workers.emplace_back(fill_blocks, block_count * worker / thread_count, block_count * (worker + 1) / thread_count);
+    }
+
+    // uniformly distributed values in [low; high)
+    constexpr void fill_numeric_dataset(std::span<int> data, uint32_t seed = 42, int low = -100, int high = 100, size_t thread_count = 0)
+    {
+        fill_dataset(data, seed, random::uniform_int_distribution<int>{low, high - 1}, thread_count);
+    }
+
+    template <size_t Size>
+    [[nodiscard]] constexpr auto create_numeric_dataset(uint32_t seed = 42, int low = -100, int high = 100)
+    {
+        std::array<int, Size> data{};
+        fill_numeric_dataset(data, seed, low, high);
+
+        return data;
+    }
+
+    template <size_t Size, random::Distribution TDistribution>
+    [[nodiscard]] constexpr auto create_numeric_dataset(uint32_t seed, TDistribution distr, random::Pattern pattern = random::Pattern::random)
+    {
+        std::array<typename TDistribution::result_type, Size> data{};
+        fill_dataset(std::span{data}, seed, distr);
+        random::apply_pattern(data, pattern, seed);
+
+        return data;
+    }
+
+    // heap allocated datasets for sizes that do not fit on the stack
+    [[nodiscard]] inline std::vector<int> create_numeric_dataset(size_t size, uint32_t seed = 42, int low = -100, int high = 100)
+    {
+        std::vector<int> data(size);
+        fill_numeric_dataset(data, seed, low, high);
+
+        return data;
+    }
+
+    template <random::Distribution TDistribution>
+    [[nodiscard]] auto create_numeric_dataset(size_t size, uint32_t seed, TDistribution distr, random::Pattern pattern = random::Pattern::random)
+    {
+        std::vector<typename TDistribution::result_type> data(size);
+        fill_dataset(std::span{data}, seed, distr);
+        random::apply_pattern(data, pattern, seed);
 
-        return result_data;
+        return data;
     }
 } // namespace helpers
 
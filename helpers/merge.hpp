@@ -0,0 +1,317 @@
+#ifndef MERGE_HPP
+#define MERGE_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// merging of sorted runs (e.g. sorted shards of a dataset) - everything is usable in constexpr functions
+//
+//   for (int id : helpers::merging::merge_unique(shards)) ... // sorted union of the shards computed lazily, duplicates skipped
+//
+// - branchless_merge - two runs, the comparison selects the element and the advanced run without a jump
+// - LoserTree - k runs, every element costs log2(k) comparisons
+namespace helpers::merging
+{
+    // stable merge of two random-access runs
+    // - the loop has no data-dependent branches, so unpredictable inputs do not pay for mispredictions
+    template <std::random_access_iterator TIterator1, std::sized_sentinel_for<TIterator1> TSentinel1,
+        std::random_access_iterator TIterator2, std::sized_sentinel_for<TIterator2> TSentinel2,
+        std::weakly_incrementable TOutput, typename TCompare = std::ranges::less>
+        requires std::mergeable<TIterator1, TIterator2, TOutput, TCompare>
+    constexpr TOutput branchless_merge(TIterator1 first1, TSentinel1 last1, TIterator2 first2, TSentinel2 last2, TOutput out, TCompare comp = {})
+    {
+        while (first1 != last1 && first2 != last2)
+        {
+            const bool take_second = std::invoke(comp, *first2, *first1); // ties are taken from the first run
+            *out = take_second ? *first2 : *first1;
+            ++out;
+            first1 += !take_second;
+            first2 += take_second;
+        }
+
+        out = std::ranges::copy(first1, last1, std::move(out)).out;
+        return std::ranges::copy(first2, last2, std::move(out)).out;
+    }
+
+    template <std::ranges::random_access_range TRange1, std::ranges::random_access_range TRange2, std::weakly_incrementable TOutput,
+        typename TCompare = std::ranges::less>
+        requires std::ranges::sized_range<TRange1> && std::ranges::sized_range<TRange2>
+        && std::mergeable<std::ranges::iterator_t<TRange1>, std::ranges::iterator_t<TRange2>, TOutput, TCompare>
+    constexpr TOutput branchless_merge(TRange1&& range1, TRange2&& range2, TOutput out, TCompare comp = {})
+    {
+        return branchless_merge(std::ranges::begin(range1), std::ranges::end(range1), std::ranges::begin(range2), std::ranges::end(range2),
+            std::move(out), std::move(comp));
+    }
+
+    // tournament tree over k sorted runs - an internal node keeps the loser of the match played there,
+    // so replacing the winner replays a single leaf-to-root path
+    // - the replay selects the new loser and winner without jumping on the comparison; a tie-break on the run index
+    //   would cost a second comparison per match, so merging equivalent elements is not stable
+    template <std::forward_iterator TIterator, std::sentinel_for<TIterator> TSentinel, typename TCompare = std::ranges::less>
+        requires std::indirect_strict_weak_order<TCompare, TIterator>
+    class LoserTree
+    {
+    public:
+        template <std::ranges::input_range TRuns>
+        constexpr explicit LoserTree(TRuns&& runs, TCompare comp = {})
+            : comp_{std::move(comp)}
+        {
+            for (auto&& run : runs)
+                runs_.push_back(Run{std::ranges::begin(run), std::ranges::end(run)});
+
+            // nodes 1..k-1 are the matches, leaf of run i is node k + i, tree_[0] is the overall winner
+            tree_.resize(std::max<std::size_t>(runs_.size(), 1));
+            if (!runs_.empty())
+                tree_[0] = play(1);
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return runs_.empty() || runs_[tree_[0]].exhausted();
+        }
+
+        // iterator to the smallest head
+        constexpr const TIterator& top() const noexcept
+        {
+            return runs_[tree_[0]].head;
+        }
+
+        constexpr std::size_t top_run() const noexcept
+        {
+            return tree_[0];
+        }
+
+        constexpr void pop()
+        {
+            std::size_t winner = tree_[0];
+            ++runs_[winner].head;
+
+            for (std::size_t node = (winner + runs_.size()) / 2; node > 0; node /= 2)
+            {
+                const std::size_t loser = tree_[node];
+                const bool loser_wins = beats(loser, winner);
+                tree_[node] = loser_wins ? winner : loser;
+                winner = loser_wins ? loser : winner;
+            }
+
+            tree_[0] = winner;
+        }
+
+    private:
+        struct Run
+        {
+            TIterator head;
+            TSentinel end;
+
+            constexpr bool exhausted() const
+            {
+                return head == end;
+            }
+        };
+
+        std::vector<Run> runs_;
+        std::vector<std::size_t> tree_;
+        TCompare comp_;
+
+        // exhausted runs lose every match, ties go to run
+        constexpr bool beats(std::size_t run, std::size_t other) const
+        {
+            const Run& lhs = runs_[run];
+            const Run& rhs = runs_[other];
+
+            if (rhs.exhausted())
+                return true;
+            if (lhs.exhausted())
+                return false;
+
+            return !std::invoke(comp_, *rhs.head, *lhs.head);
+        }
+
+        // winner of the subtree rooted at node - the losers are stored on the way up
+        constexpr std::size_t play(std::size_t node)
+        {
+            if (node >= runs_.size())
+                return node - runs_.size();
+
+            const std::size_t left = play(2 * node);
+            const std::size_t right = play(2 * node + 1);
+
+            if (beats(left, right))
+            {
+                tree_[node] = right;
+                return left;
+            }
+
+            tree_[node] = left;
+            return right;
+        }
+    };
+
+    template <typename TRuns, typename TCompare>
+    LoserTree(TRuns&&, TCompare)
+        -> LoserTree<std::ranges::iterator_t<std::ranges::range_reference_t<TRuns>>, std::ranges::sentinel_t<std::ranges::range_reference_t<TRuns>>, TCompare>;
+
+    template <typename TRuns>
+    LoserTree(TRuns&&)
+        -> LoserTree<std::ranges::iterator_t<std::ranges::range_reference_t<TRuns>>, std::ranges::sentinel_t<std::ranges::range_reference_t<TRuns>>>;
+
+    // merges k sorted runs into out - branchless_merge for two random-access runs (stable), a loser tree otherwise
+    template <std::ranges::forward_range TRuns, std::weakly_incrementable TOutput, typename TCompare = std::ranges::less>
+        requires std::ranges::forward_range<std::ranges::range_reference_t<TRuns>>
+    constexpr TOutput merge_to(TRuns&& runs, TOutput out, TCompare comp = {})
+    {
+        using Run = std::ranges::range_reference_t<TRuns>;
+
+        if constexpr (std::ranges::random_access_range<Run> && std::ranges::sized_range<Run>)
+        {
+            if (std::ranges::distance(runs) == 2)
+            {
+                auto second = std::ranges::next(std::ranges::begin(runs));
+                return branchless_merge(*std::ranges::begin(runs), *second, std::move(out), std::move(comp));
+            }
+        }
+
+        for (LoserTree tree{runs, std::move(comp)}; !tree.empty(); tree.pop())
+        {
+            *out = *tree.top();
+            ++out;
+        }
+
+        return out;
+    }
+
+    // lazy merge of a range of sorted runs - with Unique elements equivalent to the previous one are skipped
+    // (the sorted union of the runs)
+    // - the runs have to outlive the view (as with views::join)
+    template <std::ranges::forward_range V, typename TCompare, bool Unique>
+        requires std::ranges::view<V> && std::ranges::forward_range<const V> && std::ranges::forward_range<std::ranges::range_reference_t<const V>>
+    class MergeView : public std::ranges::view_interface<MergeView<V, TCompare, Unique>>
+    {
+        using Run = std::ranges::range_reference_t<const V>;
+        using Tree = LoserTree<std::ranges::iterator_t<Run>, std::ranges::sentinel_t<Run>, TCompare>;
+
+    public:
+        class Iterator
+        {
+        public:
+            using value_type = std::ranges::range_value_t<Run>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::input_iterator_tag;
+
+            constexpr std::ranges::range_reference_t<Run> operator*() const
+            {
+                return *tree_.top();
+            }
+
+            constexpr Iterator& operator++()
+            {
+                const auto emitted = tree_.top(); // runs are forward ranges - the element stays valid
+                tree_.pop();
+
+                if constexpr (Unique)
+                {
+                    while (!tree_.empty() && !std::invoke(comp_, *emitted, *tree_.top()))
+                        tree_.pop();
+                }
+
+                return *this;
+            }
+
+            constexpr void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend constexpr bool operator==(const Iterator& it, std::default_sentinel_t) noexcept
+            {
+                return it.tree_.empty();
+            }
+
+        private:
+            friend class MergeView;
+
+            Tree tree_;
+            TCompare comp_;
+
+            constexpr Iterator(const V& runs, const TCompare& comp)
+                : tree_{runs, comp}
+                , comp_{comp}
+            { }
+        };
+
+        MergeView() requires std::default_initializable<V> && std::default_initializable<TCompare> = default;
+
+        constexpr MergeView(V runs, TCompare comp)
+            : runs_{std::move(runs)}
+            , comp_{std::move(comp)}
+        { }
+
+        constexpr Iterator begin() const
+        {
+            return Iterator{runs_, comp_};
+        }
+
+        constexpr std::default_sentinel_t end() const noexcept
+        {
+            return std::default_sentinel;
+        }
+
+    private:
+        V runs_ = V();
+        TCompare comp_ = TCompare();
+    };
+
+    // merge(runs) - all elements of the runs in sorted order
+    template <std::ranges::viewable_range TRuns, typename TCompare = std::ranges::less>
+    constexpr auto merge(TRuns&& runs, TCompare comp = {})
+    {
+        return MergeView<std::views::all_t<TRuns>, TCompare, false>{std::views::all(std::forward<TRuns>(runs)), std::move(comp)};
+    }
+
+    // merge_unique(runs) - sorted union of the runs without duplicates
+    template <std::ranges::viewable_range TRuns, typename TCompare = std::ranges::less>
+    constexpr auto merge_unique(TRuns&& runs, TCompare comp = {})
+    {
+        return MergeView<std::views::all_t<TRuns>, TCompare, true>{std::views::all(std::forward<TRuns>(runs)), std::move(comp)};
+    }
+
+    namespace detail
+    {
+        template <typename TRange, typename... TRanges>
+        concept SameIterators = (std::same_as<std::ranges::iterator_t<TRange>, std::ranges::iterator_t<TRanges>> && ...)
+            && (std::same_as<std::ranges::sentinel_t<TRange>, std::ranges::sentinel_t<TRanges>> && ...);
+
+        template <typename TRange, typename... TRanges>
+        concept ContiguousOfSameValue = std::ranges::contiguous_range<TRange> && std::ranges::sized_range<TRange>
+            && ((std::ranges::contiguous_range<TRanges> && std::ranges::sized_range<TRanges>
+                && std::same_as<std::ranges::range_value_t<TRange>, std::ranges::range_value_t<TRanges>>) && ...);
+    } // namespace detail
+
+    // array of runs made of ranges of different types (e.g. std::array and std::vector) - subranges if the ranges share
+    // the iterator type, read-only spans if they are contiguous
+    template <std::ranges::forward_range TRange, std::ranges::forward_range... TRanges>
+        requires detail::SameIterators<TRange, TRanges...> || detail::ContiguousOfSameValue<TRange, TRanges...>
+    constexpr auto runs_of(TRange& range, TRanges&... ranges)
+    {
+        if constexpr (detail::SameIterators<TRange, TRanges...>)
+        {
+            return std::array{std::ranges::subrange{range}, std::ranges::subrange{ranges}...};
+        }
+        else
+        {
+            using Span = std::span<const std::ranges::range_value_t<TRange>>;
+            return std::array{Span{std::ranges::data(range), std::ranges::size(range)}, Span{std::ranges::data(ranges), std::ranges::size(ranges)}...};
+        }
+    }
+} // namespace helpers::merging
+
+#endif
@@ -1,12 +1,27 @@
 #ifndef RANDOM_HPP
 #define RANDOM_HPP
 
-#include <utility>
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <numeric>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace helpers::random
 {
+    inline constexpr std::uint64_t pcg_multiplier = 6364126223846793005ULL;
+
     struct PCG
     {
         struct pcg_32t_random_t
@@ -20,7 +35,15 @@ namespace helpers::random
         using result_type = std::uint32_t;
 
         constexpr explicit PCG(std::uint64_t seed) : rng{.state=seed}
-        {            
+        {
+        }
+
+        // seeding as in pcg32_srandom_r - every stream id selects a distinct sequence
+        constexpr PCG(std::uint64_t seed, std::uint64_t stream) : rng{.state = 0, .inc = (stream << 1u) | 1u}
+        {
+            pcg32_random_r();
+            rng.state += seed;
+            pcg32_random_r();
         }
 
         constexpr result_type operator()()
@@ -38,21 +61,272 @@ namespace helpers::random
             return std::numeric_limits<result_type>::max();
         }
 
+        // jumps delta steps ahead in O(log delta) - F. Brown, "Random Number Generation with Arbitrary Stride"
+        constexpr void advance(std::uint64_t delta)
+        {
+            std::uint64_t acc_mult = 1;
+            std::uint64_t acc_plus = 0;
+            std::uint64_t cur_mult = pcg_multiplier;
+            std::uint64_t cur_plus = rng.inc | 1;
+
+            while (delta > 0)
+            {
+                if (delta & 1)
+                {
+                    acc_mult *= cur_mult;
+                    acc_plus = acc_plus * cur_mult + cur_plus;
+                }
+
+                cur_plus = (cur_mult + 1) * cur_plus;
+                cur_mult *= cur_mult;
+                delta >>= 1;
+            }
+
+            rng.state = acc_mult * rng.state + acc_plus;
+        }
+
+        // independent generator on stream stream_id - seeded from the current state, which is left untouched
+        [[nodiscard]] constexpr PCG split(std::uint64_t stream_id) const
+        {
+            return PCG{rng.state, stream_id};
+        }
+
+        // output function (XSH RR) - uses old state for max ILP
+        static constexpr std::uint32_t output(std::uint64_t old_state)
+        {
+            std::uint32_t xor_shifted = ((old_state >> 18u) ^ old_state) >> 27u;
+            std::uint32_t rot = old_state >> 59u;
+
+            return (xor_shifted >> rot) | (xor_shifted << ((-rot) & 31));
+        }
+
     private:
         constexpr std::uint32_t pcg32_random_r()
         {
             std::uint64_t old_state = rng.state;
 
             // advance internal state
-            rng.state = old_state * 6364126223846793005ULL + (rng.inc | 1);
+            rng.state = old_state * pcg_multiplier + (rng.inc | 1);
 
-            // calculate output function (XHS RR), uses old state for max ILP
-            std::uint32_t xor_shifted = ((old_state >> 18u) ^ old_state) >> 27u;
-            std::uint32_t rot = old_state >> 59u;
+            return output(old_state);
+        }
+    };
 
-            return (xor_shifted >> rot) | (xor_shifted << ((-rot) & 31));
+    // fills out with the same values as std::ranges::generate(out, rng) using up to thread_count threads
+    // every worker starts from a copy of rng advanced to the beginning of its chunk
+    inline void generate_n(PCG& rng, std::span<std::uint32_t> out, size_t thread_count = std::thread::hardware_concurrency())
+    {
+        constexpr size_t min_chunk_size = 64 * 1024;
+
+        thread_count = std::clamp<size_t>(std::min(thread_count, out.size() / min_chunk_size), 1, 256);
+
+        if (thread_count == 1)
+        {
+            std::ranges::generate(out, std::ref(rng));
+            return;
+        }
+
+        const size_t chunk_size = (out.size() + thread_count - 1) / thread_count;
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(thread_count);
+
+            for (size_t offset = 0; offset < out.size(); offset += chunk_size)
+            {
+                workers.emplace_back([chunk = out.subspan(offset, std::min(chunk_size, out.size() - offset)), chunk_rng = rng, offset]() mutable {
+                    chunk_rng.advance(offset);
+                    std::ranges::generate(chunk, chunk_rng);
+                });
+            }
+        } // joins workers
+
+        rng.advance(out.size());
+    }
+
+    // Lanes_ independent PCG streams advanced in lockstep
+    // Output is interleaved: value i comes from lane (i % Lanes_) and lane k produces
+    // exactly the sequence of PCG{seed, first_stream + k}.
+    // The sequence does not depend on how the output is chunked between calls to fill().
+    template <size_t Lanes_>
+        requires (Lanes_ == 4 || Lanes_ == 8)
+    class MultiStreamPCG
+    {
+    public:
+        using result_type = std::uint32_t;
+
+        static constexpr size_t lanes = Lanes_;
+
+        constexpr explicit MultiStreamPCG(std::uint64_t seed, std::uint64_t first_stream = 0)
+        {
+            for (size_t lane = 0; lane < Lanes_; ++lane)
+            {
+                PCG lane_rng{seed, first_stream + lane};
+                state_[lane] = lane_rng.rng.state;
+                inc_[lane] = lane_rng.rng.inc | 1;
+            }
+        }
+
+        constexpr result_type operator()()
+        {
+            if (buffered_pos_ == Lanes_)
+            {
+                next_block(buffered_.data());
+                buffered_pos_ = 0;
+            }
+
+            return buffered_[buffered_pos_++];
         }
+
+        constexpr void fill(std::span<std::uint32_t> out)
+        {
+            size_t pos = 0;
+
+            while (buffered_pos_ < Lanes_ && pos < out.size())
+                out[pos++] = buffered_[buffered_pos_++];
+
+            const size_t full_blocks_end = pos + (out.size() - pos) / Lanes_ * Lanes_;
+
+            if (std::is_constant_evaluated())
+            {
+                for (; pos < full_blocks_end; pos += Lanes_)
+                    next_block_portable(out.data() + pos);
+            }
+            else
+            {
+                fill_blocks(out.data() + pos, (full_blocks_end - pos) / Lanes_);
+                pos = full_blocks_end;
+            }
+
+            if (pos < out.size())
+            {
+                next_block(buffered_.data());
+                buffered_pos_ = 0;
+
+                while (pos < out.size())
+                    out[pos++] = buffered_[buffered_pos_++];
+            }
+        }
+
+        static constexpr result_type min()
+        {
+            return std::numeric_limits<result_type>::min();
+        }
+
+        static constexpr result_type max()
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+    private:
+        alignas(32) std::array<std::uint64_t, Lanes_> state_{};
+        alignas(32) std::array<std::uint64_t, Lanes_> inc_{};
+        std::array<std::uint32_t, Lanes_> buffered_{};
+        size_t buffered_pos_ = Lanes_;
+
+        constexpr void next_block(std::uint32_t* out)
+        {
+            if (std::is_constant_evaluated())
+                next_block_portable(out);
+            else
+                fill_blocks(out, 1);
+        }
+
+        constexpr void next_block_portable(std::uint32_t* out)
+        {
+            for (size_t lane = 0; lane < Lanes_; ++lane)
+            {
+                out[lane] = PCG::output(state_[lane]);
+                state_[lane] = state_[lane] * pcg_multiplier + inc_[lane];
+            }
+        }
+
+#if defined(__AVX2__)
+        static __m256i mul64(__m256i a, __m256i b_lo, __m256i b_hi)
+        {
+            // AVX2 lacks 64-bit mullo - combine three 32x32->64 products
+            const __m256i a_hi = _mm256_srli_epi64(a, 32);
+            const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a_hi, b_lo), _mm256_mul_epu32(a, b_hi));
+
+            return _mm256_add_epi64(_mm256_mul_epu32(a, b_lo), _mm256_slli_epi64(cross, 32));
+        }
+
+        static __m256i output_x4(__m256i old_state)
+        {
+            const __m256i low32_mask = _mm256_set1_epi64x(0xFFFF'FFFFLL);
+
+            const __m256i xor_shifted = _mm256_and_si256(
+                _mm256_srli_epi64(_mm256_xor_si256(_mm256_srli_epi64(old_state, 18), old_state), 27), low32_mask);
+            const __m256i rot = _mm256_srli_epi64(old_state, 59);
+            const __m256i rot_left = _mm256_and_si256(_mm256_sub_epi64(_mm256_setzero_si256(), rot), _mm256_set1_epi64x(31));
+
+            const __m256i rotated = _mm256_or_si256(_mm256_srlv_epi64(xor_shifted, rot),
+                _mm256_and_si256(_mm256_sllv_epi64(xor_shifted, rot_left), low32_mask));
+
+            // gather low halves of 64-bit lanes into the low 128 bits
+            return _mm256_permutevar8x32_epi32(rotated, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+        }
+
+        void fill_blocks(std::uint32_t* out, size_t block_count)
+        {
+            const __m256i mult_lo = _mm256_set1_epi64x(pcg_multiplier & 0xFFFF'FFFFULL);
+            const __m256i mult_hi = _mm256_set1_epi64x(pcg_multiplier >> 32);
+
+            if constexpr (Lanes_ == 4)
+            {
+                __m256i state = _mm256_load_si256(reinterpret_cast<const __m256i*>(state_.data()));
+                const __m256i inc = _mm256_load_si256(reinterpret_cast<const __m256i*>(inc_.data()));
+
+                for (size_t block = 0; block < block_count; ++block, out += Lanes_)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(output_x4(state)));
+                    state = _mm256_add_epi64(mul64(state, mult_lo, mult_hi), inc);
+                }
+
+                _mm256_store_si256(reinterpret_cast<__m256i*>(state_.data()), state);
+            }
+            else
+            {
+                __m256i state_a = _mm256_load_si256(reinterpret_cast<const __m256i*>(state_.data()));
+                __m256i state_b = _mm256_load_si256(reinterpret_cast<const __m256i*>(state_.data() + 4));
+                const __m256i inc_a = _mm256_load_si256(reinterpret_cast<const __m256i*>(inc_.data()));
+                const __m256i inc_b = _mm256_load_si256(reinterpret_cast<const __m256i*>(inc_.data() + 4));
+
+                for (size_t block = 0; block < block_count; ++block, out += Lanes_)
+                {
+                    const __m256i result = _mm256_permute2x128_si256(output_x4(state_a), output_x4(state_b), 0x20);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+
+                    state_a = _mm256_add_epi64(mul64(state_a, mult_lo, mult_hi), inc_a);
+                    state_b = _mm256_add_epi64(mul64(state_b, mult_lo, mult_hi), inc_b);
+                }
+
+                _mm256_store_si256(reinterpret_cast<__m256i*>(state_.data()), state_a);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(state_.data() + 4), state_b);
+            }
+        }
+#else
+        // structure-of-arrays loop - left to the auto-vectorizer (SSE/NEON)
+        void fill_blocks(std::uint32_t* out, size_t block_count)
+        {
+            std::array<std::uint64_t, Lanes_> state = state_;
+
+            for (size_t block = 0; block < block_count; ++block, out += Lanes_)
+            {
+                for (size_t lane = 0; lane < Lanes_; ++lane)
+                {
+                    out[lane] = PCG::output(state[lane]);
+                    state[lane] = state[lane] * pcg_multiplier + inc_[lane];
+                }
+            }
+
+            state_ = state;
+        }
+#endif
     };
+
+    using PCGx4 = MultiStreamPCG<4>;
+    using PCGx8 = MultiStreamPCG<8>;
 } // namespace helpers::random
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,268 @@
+#ifndef SORT_KEYS_HPP
+#define SORT_KEYS_HPP
+
+#include "sorting.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// normalized sort keys - records compared field by field (string + numbers via <=>) are mapped to fixed-width
+// byte strings, so sorting compares a few machine words instead of chasing string pointers
+//
+//   helpers::sorting::sort_by_normalized_key(people, [](const Person& p) { return std::tie(p.name, p.age); });
+//
+// - key(a) < key(b) implies a < b, equal keys are resolved with the full comparison of the records
+// - floating point fields work for <=> and std::strong_order alike: -0.0 and +0.0 share a key, NaNs share
+//   a key per sign (no order sorts NaNs meaningfully with <=>)
+// - the fields must be the fields compared by the records' ordering (or a prefix of them), in the same order
+namespace helpers::sorting
+{
+    // fixed-width key compared as a string of unsigned bytes - stored as big-endian machine words
+    template <std::size_t Width>
+    struct NormalizedKey
+    {
+        static_assert(Width > 0 && Width % 8 == 0, "width of a normalized key must be a multiple of 8 bytes");
+
+        std::array<std::uint64_t, Width / 8> words{};
+
+        bool operator==(const NormalizedKey&) const = default;
+
+        constexpr std::strong_ordering operator<=>(const NormalizedKey& other) const noexcept
+        {
+            for (std::size_t i = 0; i < words.size(); ++i)
+            {
+                if (words[i] != other.words[i])
+                    return words[i] <=> other.words[i];
+            }
+            return std::strong_ordering::equal;
+        }
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        concept StringField = std::convertible_to<const T&, std::string_view>;
+
+        template <typename T>
+        concept FixedWidthField = (std::integral<T> || std::floating_point<T> || std::is_enum_v<T>);
+
+        template <typename T>
+        constexpr std::size_t fixed_field_width() noexcept
+        {
+            if constexpr (FixedWidthField<T>)
+                return sizeof(T);
+            else
+                return 0;
+        }
+
+        // -0.0 == +0.0 for <=>, std::strong_order tells them (and NaN payloads) apart in the tie-break
+        template <std::floating_point T>
+        constexpr T canonical_float(T value) noexcept
+        {
+            if (value == T{})
+                return T{};
+            if (value != value)
+                return radix_key(value) < radix_key(T{}) ? -std::numeric_limits<T>::quiet_NaN() : std::numeric_limits<T>::quiet_NaN();
+            return value;
+        }
+
+        template <std::size_t Width>
+        class KeyWriter
+        {
+        public:
+            std::array<char, Width> bytes{};
+            std::size_t position = 0;
+            bool truncated = false; // once a field did not fit, the following fields are not encoded
+
+            constexpr std::size_t remaining() const noexcept
+            {
+                return Width - position;
+            }
+
+            template <std::unsigned_integral T>
+            constexpr void write_big_endian(T value) noexcept
+            {
+                for (std::size_t i = sizeof(T); i-- > 0;)
+                    bytes[position++] = static_cast<char>(value >> (8 * i));
+            }
+
+            template <typename T>
+            constexpr void write(const T& value, std::size_t string_width) noexcept
+            {
+                if (truncated)
+                    return;
+
+                if constexpr (StringField<T>)
+                {
+                    // prefix padded with zeros + its length - the length byte orders a string before its extension
+                    // padded with '\0' characters; a prefix that does not hold the whole string ends the key
+                    const std::string_view text{value};
+
+                    if (string_width < 2)
+                    {
+                        truncated = true;
+                        return;
+                    }
+
+                    const std::size_t prefix_width = std::min<std::size_t>(string_width - 1, std::numeric_limits<unsigned char>::max());
+                    const std::size_t length = std::min(text.size(), prefix_width);
+
+                    std::copy_n(text.data(), length, bytes.begin() + static_cast<std::ptrdiff_t>(position));
+                    position += prefix_width;
+                    bytes[position++] = static_cast<char>(length);
+
+                    truncated = text.size() >= prefix_width;
+                }
+                else
+                {
+                    if (remaining() < sizeof(T))
+                    {
+                        truncated = true;
+                        return;
+                    }
+
+                    if constexpr (std::is_enum_v<T>)
+                        write_big_endian(radix_key(static_cast<std::underlying_type_t<T>>(value)));
+                    else if constexpr (std::same_as<T, bool>)
+                        write_big_endian(static_cast<unsigned char>(value));
+                    else if constexpr (std::floating_point<T>)
+                        write_big_endian(radix_key(canonical_float(value)));
+                    else
+                        write_big_endian(radix_key(value));
+                }
+            }
+        };
+
+        template <std::size_t Width>
+        constexpr NormalizedKey<Width> to_normalized_key(const std::array<char, Width>& bytes) noexcept
+        {
+            NormalizedKey<Width> key;
+            for (std::size_t i = 0; i < key.words.size(); ++i)
+            {
+                std::array<char, 8> word_bytes;
+                std::copy_n(bytes.begin() + static_cast<std::ptrdiff_t>(8 * i), 8, word_bytes.begin());
+
+                const auto word = std::bit_cast<std::uint64_t>(word_bytes);
+                key.words[i] = std::endian::native == std::endian::little ? std::byteswap(word) : word;
+            }
+            return key;
+        }
+    } // namespace detail
+
+    template <typename T>
+    concept NormalizableField = detail::StringField<T> || detail::FixedWidthField<T>;
+
+    // key of a sequence of fields compared lexicographically (as by a defaulted <=>)
+    // - strings share the bytes left by the fixed-width fields that follow them
+    template <std::size_t Width = 16, typename... TFields>
+        requires(NormalizableField<std::remove_cvref_t<TFields>> && ...)
+    constexpr NormalizedKey<Width> make_normalized_key(const TFields&... fields) noexcept
+    {
+        constexpr std::array<std::size_t, sizeof...(TFields)> fixed_widths{detail::fixed_field_width<std::remove_cvref_t<TFields>>()...};
+        constexpr std::array<bool, sizeof...(TFields)> is_string{detail::StringField<std::remove_cvref_t<TFields>>...};
+
+        detail::KeyWriter<Width> writer;
+        std::size_t index = 0;
+
+        auto write_field = [&](const auto& field) {
+            std::size_t fixed_tail = 0;
+            std::size_t strings_left = 0;
+            for (std::size_t i = index; i < sizeof...(TFields); ++i)
+            {
+                fixed_tail += i > index ? fixed_widths[i] : 0;
+                strings_left += is_string[i] ? 1 : 0;
+            }
+
+            const std::size_t string_width = strings_left && writer.remaining() > fixed_tail ? (writer.remaining() - fixed_tail) / strings_left : 0;
+            writer.write(field, string_width);
+            ++index;
+        };
+
+        (write_field(fields), ...);
+
+        return detail::to_normalized_key(writer.bytes);
+    }
+
+    // fields_of(record) returns a field or a tuple of fields (e.g. std::tie(p.name, p.age))
+    template <std::size_t Width = 16, typename TFieldsOf, typename T>
+    constexpr NormalizedKey<Width> normalized_key_of(const TFieldsOf& fields_of, const T& record)
+    {
+        decltype(auto) fields = std::invoke(fields_of, record);
+
+        if constexpr (requires { std::tuple_size<std::remove_cvref_t<decltype(fields)>>::value; })
+            return std::apply([](const auto&... field) { return make_normalized_key<Width>(field...); }, fields);
+        else
+            return make_normalized_key<Width>(fields);
+    }
+
+    // sorts records by comp (the records' own operator< or greater) - not stable
+    // - every record is encoded once, the (key, index) array is sorted on the keys,
+    //   runs of equal keys are ordered with comp, then the records are moved into place
+    template <std::size_t Width = 16, std::ranges::random_access_range TRange, typename TFieldsOf, typename TCompare = std::ranges::less>
+        requires std::ranges::sized_range<TRange> && std::sortable<std::ranges::iterator_t<TRange>, TCompare>
+    void sort_by_normalized_key(TRange&& range, TFieldsOf fields_of, TCompare comp = {})
+    {
+        const auto first = std::ranges::begin(range);
+        const auto size = static_cast<std::size_t>(std::ranges::size(range));
+
+        struct Item
+        {
+            NormalizedKey<Width> key;
+            std::size_t index;
+        };
+
+        // greater orders by inverted keys, any other comparator has to agree with the ascending order of the fields
+        constexpr bool descending = radix_direction<TCompare, std::ranges::range_value_t<TRange>>() < 0;
+
+        std::vector<Item> items;
+        items.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            auto key = normalized_key_of<Width>(fields_of, *(first + i));
+            if constexpr (descending)
+            {
+                for (auto& word : key.words)
+                    word = ~word;
+            }
+            items.push_back(Item{key, i});
+        }
+
+        std::ranges::sort(items, std::ranges::less{}, &Item::key);
+
+        auto record_less = [&](const Item& lhs, const Item& rhs) {
+            return std::invoke(comp, *(first + lhs.index), *(first + rhs.index));
+        };
+
+        for (auto run_begin = items.begin(); run_begin != items.end();)
+        {
+            const auto run_end = std::find_if(run_begin + 1, items.end(), [&](const Item& item) { return item.key != run_begin->key; });
+            if (run_end - run_begin > 1)
+                std::sort(run_begin, run_end, record_less);
+            run_begin = run_end;
+        }
+
+        // gathered through a buffer - sequential writes are about twice as fast as following the permutation's cycles
+        std::vector<std::ranges::range_value_t<TRange>> sorted;
+        sorted.reserve(size);
+        for (const Item& item : items)
+            sorted.push_back(std::ranges::iter_move(first + static_cast<std::ptrdiff_t>(item.index)));
+
+        std::ranges::move(sorted, first);
+    }
+} // namespace helpers::sorting
+
+#endif
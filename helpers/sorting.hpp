@@ -0,0 +1,463 @@
+#ifndef SORTING_HPP
+#define SORTING_HPP
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace helpers::sorting
+{
+    // order-preserving maps to unsigned integers - radix_key(a) < radix_key(b) iff a < b
+    template <std::integral T>
+        requires(!std::same_as<T, bool>)
+    constexpr auto radix_key(T value) noexcept
+    {
+        using Key = std::make_unsigned_t<T>;
+
+        if constexpr (std::is_signed_v<T>)
+            return static_cast<Key>(static_cast<Key>(value) ^ (Key{1} << (std::numeric_limits<Key>::digits - 1))); // flips the sign bit
+        else
+            return static_cast<Key>(value);
+    }
+
+    // IEEE 754 totalOrder - the order of std::strong_order for floating point values:
+    // -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN, NaNs of the same sign ordered by their payloads
+    template <std::floating_point T>
+    constexpr auto radix_key(T value) noexcept
+    {
+        using Key = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        static_assert(std::numeric_limits<T>::is_iec559 && sizeof(T) == sizeof(Key), "only IEEE 754 binary32 and binary64 are supported");
+
+        constexpr Key sign_bit = Key{1} << (std::numeric_limits<Key>::digits - 1);
+
+        // negative values - all bits flipped (larger magnitude sorts first), positive values - the sign bit set
+        const auto bits = std::bit_cast<Key>(value);
+        return static_cast<Key>(bits & sign_bit ? ~bits : bits | sign_bit);
+    }
+
+    // comparators ordering by std::strong_order - a total order for floating point values (NaNs included)
+    struct StrongOrderLess
+    {
+        template <typename T>
+        constexpr bool operator()(const T& lhs, const T& rhs) const
+        {
+            return std::is_lt(std::strong_order(lhs, rhs));
+        }
+    };
+
+    struct StrongOrderGreater
+    {
+        template <typename T>
+        constexpr bool operator()(const T& lhs, const T& rhs) const
+        {
+            return std::is_gt(std::strong_order(lhs, rhs));
+        }
+    };
+
+    template <typename T>
+    concept RadixSortable = requires(const T& value) {
+        { radix_key(value) } -> std::unsigned_integral;
+    };
+
+    // 1 for ascending, -1 for descending, 0 for comparators a radix sort cannot reproduce
+    template <typename TCompare, typename TKey>
+    constexpr int radix_direction()
+    {
+        if constexpr (std::same_as<TCompare, std::ranges::less> || std::same_as<TCompare, std::less<>> || std::same_as<TCompare, std::less<TKey>>
+            || std::same_as<TCompare, StrongOrderLess>)
+            return 1;
+        else if constexpr (std::same_as<TCompare, std::ranges::greater> || std::same_as<TCompare, std::greater<>> || std::same_as<TCompare, std::greater<TKey>>
+            || std::same_as<TCompare, StrongOrderGreater>)
+            return -1;
+        else
+            return 0;
+    }
+
+    // keys ordered by TCompare can be sorted by their radix_key
+    template <typename TKey, typename TCompare>
+    concept RadixOrdering = RadixSortable<TKey> && (radix_direction<TCompare, TKey>() != 0);
+
+    // radix key in the order of TCompare - descending order flips all bits
+    template <typename TCompare, typename TKey>
+        requires RadixOrdering<TKey, TCompare>
+    constexpr auto ordered_radix_key(const TKey& value) noexcept
+    {
+        const auto key = radix_key(value);
+
+        if constexpr (radix_direction<TCompare, TKey>() > 0)
+            return key;
+        else
+            return static_cast<decltype(key)>(~key);
+    }
+
+    // below this size a comparison sort beats the fixed cost of the radix histograms
+    inline constexpr std::size_t radix_sort_threshold = 256;
+
+    // below this size parallel_sort sorts on the calling thread
+    inline constexpr std::size_t parallel_sort_threshold = 1 << 16;
+
+    namespace detail
+    {
+        // digits of 11 bits need fewer passes over large inputs (6 instead of 8 for 64-bit keys),
+        // but their histograms cost more than sorting a small input
+        inline constexpr std::size_t wide_digits_threshold = 1 << 16;
+
+        template <unsigned RadixBits, typename T, typename TKeyOf>
+        void lsd_radix_sort_by_digits(T* first, T* buffer, std::size_t size, TKeyOf& key_of)
+        {
+            using Key = std::remove_cvref_t<std::invoke_result_t<TKeyOf&, const T&>>;
+            static_assert(std::unsigned_integral<Key>);
+
+            constexpr std::size_t radix_size = std::size_t{1} << RadixBits;
+
+            Key min_key = key_of(first[0]);
+            Key max_key = min_key;
+            for (std::size_t i = 1; i < size; ++i)
+            {
+                const Key key = key_of(first[i]);
+                min_key = std::min(min_key, key);
+                max_key = std::max(max_key, key);
+            }
+
+            const auto pass_count = (static_cast<unsigned>(std::bit_width(static_cast<Key>(max_key - min_key))) + RadixBits - 1) / RadixBits;
+
+            std::vector<std::array<std::size_t, radix_size>> counts(pass_count);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const Key key = static_cast<Key>(key_of(first[i]) - min_key);
+                for (unsigned pass = 0; pass < pass_count; ++pass)
+                    ++counts[pass][(key >> (pass * RadixBits)) & (radix_size - 1)];
+            }
+
+            T* source = first;
+            T* target = buffer;
+
+            for (unsigned pass = 0; pass < pass_count; ++pass)
+            {
+                auto digit_of = [&](const T& item) {
+                    return static_cast<std::size_t>(static_cast<Key>(key_of(item) - min_key) >> (pass * RadixBits)) & (radix_size - 1);
+                };
+
+                auto& offsets = counts[pass];
+                if (offsets[digit_of(source[0])] == size)
+                    continue;
+
+                std::size_t offset = 0;
+                for (auto& count : offsets)
+                    offset += std::exchange(count, offset);
+
+                for (std::size_t i = 0; i < size; ++i)
+                    target[offsets[digit_of(source[i])]++] = std::move(source[i]);
+
+                std::swap(source, target);
+            }
+
+            if (source != first)
+                std::move(source, source + size, first);
+        }
+
+        // stable LSD radix sort of [first, first + size) by the unsigned key_of(item), buffer must hold size items
+        // - keys are taken relative to the smallest one, so small-range keys (e.g. ints from [-100, 100]) need a single pass
+        // - passes in which all items share the digit are skipped
+        template <typename T, typename TKeyOf>
+        void lsd_radix_sort(T* first, T* buffer, std::size_t size, TKeyOf key_of)
+        {
+            if (size < 2)
+                return;
+
+            if (size < wide_digits_threshold)
+                lsd_radix_sort_by_digits<8>(first, buffer, size, key_of);
+            else
+                lsd_radix_sort_by_digits<11>(first, buffer, size, key_of);
+        }
+
+        // moves *(first + permutation[i]) to position i - the permutation is consumed (reset to identity)
+        template <std::random_access_iterator TIterator, typename TIndex>
+        void apply_permutation(TIterator first, std::vector<TIndex>& permutation)
+        {
+            for (std::size_t i = 0; i < permutation.size(); ++i)
+            {
+                if (permutation[i] == i)
+                    continue;
+
+                // follow the cycle starting at i
+                std::iter_value_t<TIterator> value = std::ranges::iter_move(first + i);
+                std::size_t hole = i;
+
+                while (true)
+                {
+                    const std::size_t source = std::exchange(permutation[hole], static_cast<TIndex>(hole));
+                    if (source == i)
+                        break;
+
+                    *(first + hole) = std::ranges::iter_move(first + source);
+                    hole = source;
+                }
+
+                *(first + hole) = std::move(value);
+            }
+        }
+
+        template <typename TIndex, std::random_access_iterator TIterator, typename TCompare, typename TProjection>
+        void sort_by_key(TIterator first, std::size_t size, TCompare& comp, TProjection& proj)
+        {
+            using Key = std::remove_cvref_t<std::invoke_result_t<TProjection&, std::iter_reference_t<TIterator>>>;
+
+            std::vector<TIndex> permutation(size);
+
+            if constexpr (RadixOrdering<Key, TCompare>)
+            {
+                using RadixKey = decltype(ordered_radix_key<TCompare>(std::declval<const Key&>()));
+
+                struct Item
+                {
+                    RadixKey key;
+                    TIndex index;
+                };
+
+                std::vector<Item> items(size);
+                for (std::size_t i = 0; i < size; ++i)
+                    items[i] = Item{ordered_radix_key<TCompare>(std::invoke(proj, *(first + i))), static_cast<TIndex>(i)};
+
+                if (size < radix_sort_threshold)
+                {
+                    std::ranges::stable_sort(items, std::ranges::less{}, &Item::key);
+                }
+                else
+                {
+                    std::vector<Item> buffer(size);
+                    lsd_radix_sort(items.data(), buffer.data(), size, [](const Item& item) { return item.key; });
+                }
+
+                for (std::size_t i = 0; i < size; ++i)
+                    permutation[i] = items[i].index;
+            }
+            else
+            {
+                struct Item
+                {
+                    Key key;
+                    TIndex index;
+                };
+
+                std::vector<Item> items;
+                items.reserve(size);
+                for (std::size_t i = 0; i < size; ++i)
+                    items.push_back(Item{std::invoke(proj, *(first + i)), static_cast<TIndex>(i)});
+
+                std::ranges::stable_sort(items, comp, &Item::key);
+
+                for (std::size_t i = 0; i < size; ++i)
+                    permutation[i] = items[i].index;
+            }
+
+            apply_permutation(first, permutation);
+        }
+    } // namespace detail
+
+    // stable sort evaluating the projection once per element
+    // - (key, index) pairs are sorted (radix sort for integral keys ordered by less/greater), then the elements
+    //   are permuted in place - worth it when the projection parses, hashes or chases pointers
+    template <std::random_access_iterator TIterator, std::sentinel_for<TIterator> TSentinel, typename TProjection, typename TCompare = std::ranges::less>
+        requires std::sortable<TIterator, TCompare, TProjection> && std::copy_constructible<std::remove_cvref_t<std::indirect_result_t<TProjection&, TIterator>>>
+    TIterator sort_by_key(TIterator first, TSentinel last, TProjection proj, TCompare comp = {})
+    {
+        const TIterator end = std::ranges::next(first, last);
+        const auto size = static_cast<std::size_t>(end - first);
+
+        if (size <= std::numeric_limits<std::uint32_t>::max())
+            detail::sort_by_key<std::uint32_t>(first, size, comp, proj);
+        else
+            detail::sort_by_key<std::size_t>(first, size, comp, proj);
+
+        return end;
+    }
+
+    template <std::ranges::random_access_range TRange, typename TProjection, typename TCompare = std::ranges::less>
+        requires std::sortable<std::ranges::iterator_t<TRange>, TCompare, TProjection>
+        && std::copy_constructible<std::remove_cvref_t<std::indirect_result_t<TProjection&, std::ranges::iterator_t<TRange>>>>
+    std::ranges::borrowed_iterator_t<TRange> sort_by_key(TRange&& range, TProjection proj, TCompare comp = {})
+    {
+        return sort_by_key(std::ranges::begin(range), std::ranges::end(range), std::move(proj), std::move(comp));
+    }
+
+    // drop-in for std::ranges::sort (stable when the radix path is taken)
+    // - LSD radix sort for integral and floating point values ordered by less/greater (or StrongOrderLess/StrongOrderGreater),
+    //   sort_by_key for such projections, std::ranges::sort otherwise
+    // - floating point values are sorted as by std::strong_order - with less -0.0 goes before 0.0 and NaNs go to the ends
+    template <std::random_access_iterator TIterator, std::sentinel_for<TIterator> TSentinel, typename TCompare = std::ranges::less, typename TProjection = std::identity>
+        requires std::sortable<TIterator, TCompare, TProjection>
+    TIterator radix_sort(TIterator first, TSentinel last, TCompare comp = {}, TProjection proj = {})
+    {
+        using Value = std::iter_value_t<TIterator>;
+        using Key = std::remove_cvref_t<std::indirect_result_t<TProjection&, TIterator>>;
+
+        const TIterator end = std::ranges::next(first, last);
+        const auto size = static_cast<std::size_t>(end - first);
+
+        if constexpr (!RadixOrdering<Key, TCompare>)
+        {
+            return std::ranges::sort(first, end, std::move(comp), std::move(proj));
+        }
+        else if (size < radix_sort_threshold)
+        {
+            // compared by the radix keys - the same order as the radix path (less is not a strict weak order for NaNs)
+            return std::ranges::sort(first, end, std::ranges::less{}, [&proj](const Value& value) { return ordered_radix_key<TCompare>(std::invoke(proj, value)); });
+        }
+        else if constexpr (std::same_as<TProjection, std::identity> && std::contiguous_iterator<TIterator>)
+        {
+            std::vector<Value> buffer(size);
+            detail::lsd_radix_sort(std::to_address(first), buffer.data(), size, [](const Value& value) { return ordered_radix_key<TCompare>(value); });
+            return end;
+        }
+        else
+        {
+            return sort_by_key(first, end, std::move(proj), std::move(comp));
+        }
+    }
+
+    template <std::ranges::random_access_range TRange, typename TCompare = std::ranges::less, typename TProjection = std::identity>
+        requires std::sortable<std::ranges::iterator_t<TRange>, TCompare, TProjection>
+    std::ranges::borrowed_iterator_t<TRange> radix_sort(TRange&& range, TCompare comp = {}, TProjection proj = {})
+    {
+        return radix_sort(std::ranges::begin(range), std::ranges::end(range), std::move(comp), std::move(proj));
+    }
+
+    // parallel sample sort on the pool and the calling thread - not stable
+    // - splitters are picked from a sorted random sample, elements are classified into buckets
+    //   between consecutive splitters and buckets of elements equal to a splitter (so duplicates do not unbalance the buckets),
+    //   scattered to a buffer, and the buckets are sorted (with radix_sort) independently
+    template <std::ranges::random_access_range TRange, typename TCompare = std::ranges::less, typename TProjection = std::identity>
+        requires std::ranges::sized_range<TRange> && std::sortable<std::ranges::iterator_t<TRange>, TCompare, TProjection>
+        && std::default_initializable<std::ranges::range_value_t<TRange>>
+        && std::copy_constructible<std::remove_cvref_t<std::indirect_result_t<TProjection&, std::ranges::iterator_t<TRange>>>>
+    void parallel_sort(ThreadPool& pool, TRange&& range, TCompare comp = {}, TProjection proj = {})
+    {
+        using Value = std::ranges::range_value_t<TRange>;
+        using Key = std::remove_cvref_t<std::indirect_result_t<TProjection&, std::ranges::iterator_t<TRange>>>;
+
+        const auto size = static_cast<std::size_t>(std::ranges::size(range));
+        const std::size_t thread_count = pool.size() + 1;
+
+        if (size < parallel_sort_threshold || thread_count == 1)
+        {
+            radix_sort(range, std::move(comp), std::move(proj));
+            return;
+        }
+
+        const auto first = std::ranges::begin(range);
+
+        // radix-ordered keys are classified by their radix keys - cheaper to compare and totally ordered (NaNs included)
+        auto splitter_key = [&proj](const Value& value) -> decltype(auto) {
+            if constexpr (RadixOrdering<Key, TCompare>)
+                return ordered_radix_key<TCompare>(std::invoke(proj, value));
+            else
+                return std::invoke(proj, value);
+        };
+
+        auto splitter_comp = [&comp] {
+            if constexpr (RadixOrdering<Key, TCompare>)
+                return std::ranges::less{};
+            else
+                return comp;
+        }();
+
+        using SplitterKey = std::remove_cvref_t<decltype(splitter_key(*first))>;
+
+        // splitters - every oversampling-th key of a sorted random sample, duplicates removed
+        constexpr std::size_t oversampling = 16;
+        const std::size_t splitter_count = 4 * thread_count - 1;
+
+        std::vector<SplitterKey> splitters;
+        {
+            std::minstd_rand rnd{static_cast<std::uint32_t>(size)};
+            std::uniform_int_distribution<std::size_t> random_index{0, size - 1};
+
+            std::vector<SplitterKey> sample;
+            sample.reserve((splitter_count + 1) * oversampling);
+            for (std::size_t i = 0; i < (splitter_count + 1) * oversampling; ++i)
+                sample.push_back(splitter_key(*(first + random_index(rnd))));
+
+            std::ranges::sort(sample, splitter_comp);
+
+            for (std::size_t i = oversampling; i < sample.size(); i += oversampling)
+            {
+                if (splitters.empty() || std::invoke(splitter_comp, splitters.back(), sample[i]))
+                    splitters.push_back(sample[i]);
+            }
+        }
+
+        // bucket 2i - keys between splitters i-1 and i, bucket 2i+1 - keys equivalent to splitter i
+        const std::size_t bucket_count = 2 * splitters.size() + 1;
+        auto bucket_of = [&](const Value& value) {
+            const SplitterKey& key = splitter_key(value);
+            const auto index = static_cast<std::size_t>(std::ranges::lower_bound(splitters, key, splitter_comp) - splitters.begin());
+            return index < splitters.size() && !std::invoke(splitter_comp, key, splitters[index]) ? 2 * index + 1 : 2 * index;
+        };
+
+        const std::size_t block_count = 4 * thread_count;
+        const std::size_t block_size = (size + block_count - 1) / block_count;
+        auto block_range = [&](std::size_t block) {
+            return std::pair{std::min(block * block_size, size), std::min((block + 1) * block_size, size)};
+        };
+
+        // offsets[block * bucket_count + bucket] - counts first, then the scatter positions
+        std::vector<std::size_t> offsets(block_count * bucket_count);
+        std::vector<std::uint32_t> buckets(size);
+
+        parallel_for(pool, block_count, [&](std::size_t block) {
+            const auto [begin, end] = block_range(block);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                buckets[i] = static_cast<std::uint32_t>(bucket_of(*(first + i)));
+                ++offsets[block * bucket_count + buckets[i]];
+            }
+        });
+
+        std::vector<std::size_t> bucket_begins(bucket_count + 1);
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < bucket_count; ++bucket)
+        {
+            bucket_begins[bucket] = offset;
+            for (std::size_t block = 0; block < block_count; ++block)
+                offset += std::exchange(offsets[block * bucket_count + bucket], offset);
+        }
+        bucket_begins[bucket_count] = size;
+
+        std::vector<Value> buffer(size);
+
+        parallel_for(pool, block_count, [&](std::size_t block) {
+            const auto [begin, end] = block_range(block);
+            std::size_t* block_offsets = offsets.data() + block * bucket_count;
+            for (std::size_t i = begin; i < end; ++i)
+                buffer[block_offsets[buckets[i]]++] = std::ranges::iter_move(first + i);
+        });
+
+        parallel_for(pool, bucket_count, [&](std::size_t bucket) {
+            const auto bucket_begin = buffer.begin() + static_cast<std::ptrdiff_t>(bucket_begins[bucket]);
+            const auto bucket_end = buffer.begin() + static_cast<std::ptrdiff_t>(bucket_begins[bucket + 1]);
+
+            if (bucket % 2 == 0) // equality buckets are already sorted
+                radix_sort(bucket_begin, bucket_end, comp, proj);
+
+            std::ranges::move(bucket_begin, bucket_end, first + static_cast<std::ptrdiff_t>(bucket_begins[bucket]));
+        });
+    }
+} // namespace helpers::sorting
+
+#endif
@@ -0,0 +1,506 @@
+#ifndef STATISTICS_HPP
+#define STATISTICS_HPP
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// one-pass statistics of streams in bounded memory - every accumulator has add(value) and merge(other),
+// so threads (or shards) summarize their part and the partial results are merged instead of materializing the data
+//
+//   auto summary = helpers::statistics::summarize(pool, events); // summarize(events) - on the calling thread
+//   summary.moments.mean(); summary.quantiles.quantile(0.99); summary.distinct.count();
+namespace helpers::statistics
+{
+    // count, mean and variance - Welford's update, Chan's formula for merging
+    class Moments
+    {
+    public:
+        constexpr void add(double value) noexcept
+        {
+            ++count_;
+            const double delta = value - mean_;
+            mean_ += delta / static_cast<double>(count_);
+            m2_ += delta * (value - mean_);
+        }
+
+        constexpr void merge(const Moments& other) noexcept
+        {
+            if (other.count_ == 0)
+                return;
+
+            if (count_ == 0)
+            {
+                *this = other;
+                return;
+            }
+
+            const std::uint64_t count = count_ + other.count_;
+            const double delta = other.mean_ - mean_;
+            const double other_share = static_cast<double>(other.count_) / static_cast<double>(count);
+
+            mean_ += delta * other_share;
+            m2_ += other.m2_ + delta * delta * static_cast<double>(count_) * other_share;
+            count_ = count;
+        }
+
+        constexpr std::uint64_t count() const noexcept
+        {
+            return count_;
+        }
+
+        constexpr double mean() const noexcept
+        {
+            return count_ ? mean_ : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        // population variance
+        constexpr double variance() const noexcept
+        {
+            return count_ ? m2_ / static_cast<double>(count_) : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        constexpr double sample_variance() const noexcept
+        {
+            return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        double stddev() const
+        {
+            return std::sqrt(variance());
+        }
+
+    private:
+        std::uint64_t count_ = 0;
+        double mean_ = 0.0;
+        double m2_ = 0.0; // sum of squared differences from the mean
+    };
+
+    template <typename T, typename TCompare = std::ranges::less>
+    class MinMax
+    {
+    public:
+        constexpr void add(const T& value)
+        {
+            if (!min_ || std::invoke(comp_, value, *min_))
+                min_ = value;
+            if (!max_ || std::invoke(comp_, *max_, value))
+                max_ = value;
+        }
+
+        constexpr void merge(const MinMax& other)
+        {
+            if (other.min_)
+            {
+                add(*other.min_);
+                add(*other.max_);
+            }
+        }
+
+        constexpr const std::optional<T>& min() const noexcept
+        {
+            return min_;
+        }
+
+        constexpr const std::optional<T>& max() const noexcept
+        {
+            return max_;
+        }
+
+    private:
+        std::optional<T> min_;
+        std::optional<T> max_;
+        TCompare comp_{};
+    };
+
+    // KLL quantile sketch (Karnin, Lang, Liberty) - values are kept in compactors of weights 1, 2, 4...;
+    // a full compactor is sorted and every other value (from a random offset) moves to the next level with twice the weight
+    // - capacities shrink by 2/3 below the top level, so about 3 * k values are kept however long the stream is
+    // - the rank error shrinks as 1 / k (k = 200 - ranks off by less than 1% of the count)
+    template <typename T, typename TCompare = std::ranges::less>
+    class KllSketch
+    {
+    public:
+        static constexpr std::size_t default_k = 200;
+
+        explicit KllSketch(std::size_t k = default_k, std::uint32_t seed = 42)
+            : k_{std::max<std::size_t>(k, 8)}
+            , rnd_{seed}
+        {
+            grow();
+        }
+
+        void add(const T& value)
+        {
+            compactors_[0].push_back(value);
+            ++count_;
+
+            if (++retained_ >= max_retained_)
+                compress();
+        }
+
+        void merge(const KllSketch& other)
+        {
+            while (compactors_.size() < other.compactors_.size())
+                grow();
+
+            for (std::size_t level = 0; level < other.compactors_.size(); ++level)
+                compactors_[level].insert(compactors_[level].end(), other.compactors_[level].begin(), other.compactors_[level].end());
+
+            count_ += other.count_;
+            retained_ += other.retained_;
+
+            while (retained_ >= max_retained_)
+                compress();
+        }
+
+        std::uint64_t count() const noexcept
+        {
+            return count_;
+        }
+
+        // number of values kept by the sketch
+        std::size_t retained() const noexcept
+        {
+            return retained_;
+        }
+
+        // estimated number of values not greater than value
+        std::uint64_t rank(const T& value) const
+        {
+            std::uint64_t rank = 0;
+            for (std::size_t level = 0; level < compactors_.size(); ++level)
+            {
+                for (const T& item : compactors_[level])
+                    rank += std::invoke(comp_, value, item) ? 0 : std::uint64_t{1} << level;
+            }
+            return rank;
+        }
+
+        // estimated value at the normalized rank q from [0, 1] - quantile(0.5) is the median
+        std::optional<T> quantile(double q) const
+        {
+            if (count_ == 0)
+                return std::nullopt;
+
+            std::vector<std::pair<T, std::uint64_t>> weighted_items;
+            weighted_items.reserve(retained_);
+            for (std::size_t level = 0; level < compactors_.size(); ++level)
+            {
+                for (const T& item : compactors_[level])
+                    weighted_items.emplace_back(item, std::uint64_t{1} << level);
+            }
+
+            std::ranges::sort(weighted_items, comp_, &std::pair<T, std::uint64_t>::first);
+
+            // the weights sum up to count_ - a compaction replaces two values by one of twice the weight
+            const double target = std::clamp(q, 0.0, 1.0) * static_cast<double>(count_);
+            std::uint64_t cumulative_weight = 0;
+            for (const auto& [item, weight] : weighted_items)
+            {
+                cumulative_weight += weight;
+                if (static_cast<double>(cumulative_weight) >= target)
+                    return item;
+            }
+
+            return weighted_items.back().first;
+        }
+
+    private:
+        std::size_t k_;
+        std::vector<std::vector<T>> compactors_;
+        std::uint64_t count_ = 0;
+        std::size_t retained_ = 0;
+        std::size_t max_retained_ = 0;
+        std::minstd_rand rnd_;
+        TCompare comp_{};
+
+        std::size_t capacity(std::size_t level) const
+        {
+            const auto depth = static_cast<double>(compactors_.size() - level - 1);
+            return static_cast<std::size_t>(std::ceil(static_cast<double>(k_) * std::pow(2.0 / 3.0, depth))) + 1;
+        }
+
+        void grow()
+        {
+            compactors_.emplace_back();
+
+            max_retained_ = 0;
+            for (std::size_t level = 0; level < compactors_.size(); ++level)
+                max_retained_ += capacity(level);
+        }
+
+        // compacts full levels from the bottom until the sketch is below its capacity
+        void compress()
+        {
+            for (std::size_t level = 0; level < compactors_.size(); ++level)
+            {
+                if (compactors_[level].size() < capacity(level))
+                    continue;
+
+                if (level + 1 == compactors_.size())
+                    grow();
+
+                auto& compactor = compactors_[level];
+                auto& next = compactors_[level + 1];
+
+                std::ranges::sort(compactor, comp_);
+
+                // an odd value (the smallest) stays at its level
+                const std::size_t kept = compactor.size() % 2;
+                for (std::size_t i = kept + rnd_() % 2; i < compactor.size(); i += 2)
+                    next.push_back(std::move(compactor[i]));
+
+                retained_ -= (compactor.size() - kept) / 2;
+                compactor.erase(compactor.begin() + static_cast<std::ptrdiff_t>(kept), compactor.end());
+
+                if (retained_ < max_retained_)
+                    break;
+            }
+        }
+    };
+
+    namespace detail
+    {
+        // splitmix64 finalizer - std::hash of integers is the identity, HyperLogLog needs uniformly spread bits
+        constexpr std::uint64_t mix_hash(std::uint64_t hash) noexcept
+        {
+            hash ^= hash >> 30;
+            hash *= 0xbf58476d1ce4e5b9ULL;
+            hash ^= hash >> 27;
+            hash *= 0x94d049bb133111ebULL;
+            hash ^= hash >> 31;
+            return hash;
+        }
+    } // namespace detail
+
+    // number of distinct values - exact (a set of 64-bit hashes) up to exact_limit values, then a HyperLogLog sketch
+    // of 2^14 registers (16 KiB, standard error ~0.8%) estimated with Ertl's improved estimator (no bias tables needed)
+    template <typename T, typename THash = std::hash<T>>
+    class DistinctCounter
+    {
+    public:
+        static constexpr unsigned precision = 14;
+        static constexpr std::size_t register_count = std::size_t{1} << precision;
+
+        explicit DistinctCounter(std::size_t exact_limit = 4096, THash hash = {})
+            : exact_limit_{exact_limit}
+            , hash_{std::move(hash)}
+        { }
+
+        void add(const T& value)
+        {
+            add_hash(detail::mix_hash(static_cast<std::uint64_t>(std::invoke(hash_, value))));
+        }
+
+        void merge(const DistinctCounter& other)
+        {
+            if (other.is_exact())
+            {
+                for (std::uint64_t hash : other.exact_hashes_)
+                    add_hash(hash);
+                return;
+            }
+
+            switch_to_sketch();
+            for (std::size_t i = 0; i < register_count; ++i)
+                registers_[i] = std::max(registers_[i], other.registers_[i]);
+        }
+
+        bool is_exact() const noexcept
+        {
+            return registers_.empty();
+        }
+
+        // exact in the exact mode, estimated otherwise
+        std::uint64_t count() const
+        {
+            if (is_exact())
+                return exact_hashes_.size();
+
+            return static_cast<std::uint64_t>(std::llround(estimate()));
+        }
+
+    private:
+        static constexpr unsigned max_rank = 64 - precision + 1;
+
+        std::size_t exact_limit_;
+        THash hash_;
+        std::unordered_set<std::uint64_t> exact_hashes_;
+        std::vector<std::uint8_t> registers_; // empty in the exact mode
+
+        void add_hash(std::uint64_t hash)
+        {
+            if (!is_exact())
+            {
+                update_register(hash);
+                return;
+            }
+
+            exact_hashes_.insert(hash);
+            if (exact_hashes_.size() > exact_limit_)
+                switch_to_sketch();
+        }
+
+        void switch_to_sketch()
+        {
+            if (!is_exact())
+                return;
+
+            registers_.assign(register_count, 0);
+            for (std::uint64_t hash : exact_hashes_)
+                update_register(hash);
+
+            std::unordered_set<std::uint64_t>{}.swap(exact_hashes_); // releases the memory
+        }
+
+        // the top bits select the register, the register keeps the maximal position of the first 1-bit in the rest
+        void update_register(std::uint64_t hash)
+        {
+            const auto index = static_cast<std::size_t>(hash >> (64 - precision));
+            const auto rank = static_cast<std::uint8_t>(std::min<unsigned>(static_cast<unsigned>(std::countl_zero(hash << precision)), max_rank - 1) + 1);
+            registers_[index] = std::max(registers_[index], rank);
+        }
+
+        // O. Ertl, "New cardinality estimation algorithms for HyperLogLog sketches" (2017)
+        double estimate() const
+        {
+            std::array<std::size_t, max_rank + 1> histogram{};
+            for (std::uint8_t rank : registers_)
+                ++histogram[rank];
+
+            const auto m = static_cast<double>(register_count);
+
+            double z = m * tau(1.0 - static_cast<double>(histogram[max_rank]) / m);
+            for (unsigned rank = max_rank - 1; rank >= 1; --rank)
+                z = 0.5 * (z + static_cast<double>(histogram[rank]));
+            z += m * sigma(static_cast<double>(histogram[0]) / m);
+
+            return m * m / (2.0 * std::log(2.0) * z);
+        }
+
+        static double sigma(double x)
+        {
+            if (x == 1.0)
+                return std::numeric_limits<double>::infinity();
+
+            double y = 1.0;
+            double z = x;
+            for (double previous = -1.0; z != previous;)
+            {
+                x *= x;
+                previous = z;
+                z += x * y;
+                y += y;
+            }
+            return z;
+        }
+
+        static double tau(double x)
+        {
+            if (x == 0.0 || x == 1.0)
+                return 0.0;
+
+            double y = 1.0;
+            double z = 1.0 - x;
+            for (double previous = -1.0; z != previous;)
+            {
+                x = std::sqrt(x);
+                previous = z;
+                y *= 0.5;
+                z -= (1.0 - x) * (1.0 - x) * y;
+            }
+            return z / 3.0;
+        }
+    };
+
+    // all statistics of a stream of numbers in one pass
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    struct Summary
+    {
+        Moments moments;
+        MinMax<T> extremes;
+        KllSketch<T> quantiles;
+        DistinctCounter<T> distinct;
+
+        // sketches merged together should be seeded differently - their random compactions do not correlate then
+        explicit Summary(std::uint32_t seed = 42)
+            : quantiles{KllSketch<T>::default_k, seed}
+        { }
+
+        void add(const T& value)
+        {
+            moments.add(static_cast<double>(value));
+            extremes.add(value);
+            quantiles.add(value);
+            distinct.add(value);
+        }
+
+        void merge(const Summary& other)
+        {
+            moments.merge(other.moments);
+            extremes.merge(other.extremes);
+            quantiles.merge(other.quantiles);
+            distinct.merge(other.distinct);
+        }
+    };
+
+    template <std::ranges::input_range TRange>
+        requires std::is_arithmetic_v<std::ranges::range_value_t<TRange>>
+    Summary<std::ranges::range_value_t<TRange>> summarize(TRange&& range)
+    {
+        Summary<std::ranges::range_value_t<TRange>> summary;
+        for (auto&& value : range)
+            summary.add(value);
+        return summary;
+    }
+
+    // parts of the range are summarized on the pool and the calling thread, then merged
+    template <std::ranges::random_access_range TRange>
+        requires std::ranges::sized_range<TRange> && std::is_arithmetic_v<std::ranges::range_value_t<TRange>>
+    Summary<std::ranges::range_value_t<TRange>> summarize(ThreadPool& pool, TRange&& range)
+    {
+        using Value = std::ranges::range_value_t<TRange>;
+
+        // a part costs a few KiB of sketches and a final merge
+        constexpr std::size_t min_part_size = 1 << 14;
+
+        const auto size = static_cast<std::size_t>(std::ranges::size(range));
+        const std::size_t part_count = std::clamp<std::size_t>(size / min_part_size, 1, 4 * (pool.size() + 1));
+
+        std::vector<Summary<Value>> parts;
+        parts.reserve(part_count);
+        for (std::size_t part = 0; part < part_count; ++part)
+            parts.emplace_back(static_cast<std::uint32_t>(part + 1));
+
+        const auto first = std::ranges::begin(range);
+        parallel_for(pool, part_count, [&](std::size_t part) {
+            const auto begin = static_cast<std::ptrdiff_t>(part * size / part_count);
+            const auto end = static_cast<std::ptrdiff_t>((part + 1) * size / part_count);
+            for (auto it = first + begin; it != first + end; ++it)
+                parts[part].add(*it);
+        });
+
+        for (std::size_t part = 1; part < part_count; ++part)
+            parts[0].merge(parts[part]);
+
+        return std::move(parts[0]);
+    }
+} // namespace helpers::statistics
+
+#endif
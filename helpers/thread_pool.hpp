@@ -0,0 +1,403 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace helpers
+{
+    // Chase-Lev work-stealing deque
+    // N. M. Le, A. Pop, A. Cohen, F. Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models"
+    // - push/pop from the bottom by the owner thread only, steal from the top by any thread
+    class WorkStealingDeque
+    {
+    public:
+        explicit WorkStealingDeque(std::size_t initial_capacity = 256)
+        {
+            buffers_.push_back(std::make_unique<Buffer>(std::bit_ceil(initial_capacity)));
+            buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        void push(std::coroutine_handle<> item)
+        {
+            const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+            const std::int64_t top = top_.load(std::memory_order_acquire);
+            Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+            if (bottom - top > static_cast<std::int64_t>(buffer->capacity) - 1)
+                buffer = grow(buffer, top, bottom);
+
+            buffer->put(bottom, item.address());
+            bottom_.store(bottom + 1, std::memory_order_release); // publishes the item to thieves
+        }
+
+        std::coroutine_handle<> pop()
+        {
+            const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+            Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+            bottom_.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = top_.load(std::memory_order_relaxed);
+
+            if (top > bottom) // empty
+            {
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            void* item = buffer->get(bottom);
+
+            if (top == bottom) // last item - race against thieves
+            {
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = nullptr;
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return std::coroutine_handle<>::from_address(item);
+        }
+
+        std::coroutine_handle<> steal()
+        {
+            std::int64_t top = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return nullptr;
+
+            void* item = buffer_.load(std::memory_order_acquire)->get(top);
+
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr; // lost the race
+
+            return std::coroutine_handle<>::from_address(item);
+        }
+
+        bool empty() const
+        {
+            return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Buffer
+        {
+            std::size_t capacity;
+            std::unique_ptr<std::atomic<void*>[]> items;
+
+            explicit Buffer(std::size_t capacity)
+                : capacity{capacity}
+                , items{new std::atomic<void*>[capacity]}
+            { }
+
+            void put(std::int64_t index, void* item) { items[static_cast<std::size_t>(index) & (capacity - 1)].store(item, std::memory_order_relaxed); }
+            void* get(std::int64_t index) const { return items[static_cast<std::size_t>(index) & (capacity - 1)].load(std::memory_order_relaxed); }
+        };
+
+        alignas(64) std::atomic<std::int64_t> top_{0};
+        alignas(64) std::atomic<std::int64_t> bottom_{0};
+        alignas(64) std::atomic<Buffer*> buffer_{nullptr};
+        std::vector<std::unique_ptr<Buffer>> buffers_; // old buffers are kept alive - thieves may still read them
+
+        Buffer* grow(Buffer* buffer, std::int64_t top, std::int64_t bottom)
+        {
+            auto bigger = std::make_unique<Buffer>(buffer->capacity * 2);
+            for (std::int64_t i = top; i < bottom; ++i)
+                bigger->put(i, buffer->get(i));
+
+            buffers_.push_back(std::move(bigger));
+            buffer_.store(buffers_.back().get(), std::memory_order_release);
+
+            return buffers_.back().get();
+        }
+    };
+
+    namespace detail
+    {
+        // coroutine started eagerly and destroyed on completion - wraps plain callables submitted to the pool
+        struct DetachedTask
+        {
+            struct promise_type
+            {
+                DetachedTask get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept { }
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+    } // namespace detail
+
+    // work-stealing scheduler of coroutines
+    // - every worker owns a Chase-Lev deque, work scheduled from a worker goes to its own deque (LIFO),
+    //   work from other threads goes to a shared injection queue
+    // - idle workers steal from randomly chosen victims before going to sleep
+    class ThreadPool
+    {
+    public:
+        explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency())
+        {
+            thread_count = std::max<std::size_t>(thread_count, 1);
+
+            queues_.reserve(thread_count);
+            for (std::size_t i = 0; i < thread_count; ++i)
+                queues_.push_back(std::make_unique<WorkStealingDeque>());
+
+            workers_.reserve(thread_count);
+            for (std::size_t i = 0; i < thread_count; ++i)
+                workers_.emplace_back([this, i] { run_worker(i); });
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // already scheduled work is completed before the workers exit
+        ~ThreadPool()
+        {
+            stop_requested_.store(true);
+            wake_up(true);
+
+            for (auto& worker : workers_)
+                worker.join();
+        }
+
+        std::size_t size() const noexcept { return workers_.size(); }
+
+        void schedule(std::coroutine_handle<> handle)
+        {
+            if (current_worker().pool == this)
+            {
+                queues_[current_worker().index]->push(handle);
+            }
+            else
+            {
+                std::lock_guard lk{injection_mtx_};
+                injection_queue_.push_back(handle);
+                has_injected_work_.store(true, std::memory_order_relaxed);
+            }
+
+            wake_up(false);
+        }
+
+        template <std::invocable TFunction>
+        void submit(TFunction&& function)
+        {
+            [](ThreadPool& pool, std::decay_t<TFunction> function) -> detail::DetachedTask {
+                co_await pool.schedule();
+                function();
+            }(*this, std::forward<TFunction>(function));
+        }
+
+        // co_await pool.schedule() - continues the coroutine on one of the workers
+        auto schedule() noexcept
+        {
+            struct ScheduleAwaiter
+            {
+                ThreadPool& pool;
+
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> handle) const { pool.schedule(handle); }
+                void await_resume() const noexcept { }
+            };
+
+            return ScheduleAwaiter{*this};
+        }
+
+        bool is_worker_thread() const noexcept
+        {
+            return current_worker().pool == this;
+        }
+
+    private:
+        struct WorkerContext
+        {
+            ThreadPool* pool = nullptr;
+            std::size_t index = 0;
+        };
+
+        static WorkerContext& current_worker() noexcept
+        {
+            thread_local WorkerContext context;
+            return context;
+        }
+
+        std::vector<std::unique_ptr<WorkStealingDeque>> queues_;
+        std::vector<std::thread> workers_;
+
+        std::mutex injection_mtx_;
+        std::deque<std::coroutine_handle<>> injection_queue_;
+        std::atomic<bool> has_injected_work_{false};
+
+        alignas(64) std::atomic<std::uint64_t> wake_epoch_{0};
+        alignas(64) std::atomic<std::size_t> sleeping_{0};
+        std::atomic<bool> stop_requested_{false};
+
+        void wake_up(bool all)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (sleeping_.load(std::memory_order_seq_cst) == 0 && !all)
+                return;
+
+            wake_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            if (all)
+                wake_epoch_.notify_all();
+            else
+                wake_epoch_.notify_one();
+        }
+
+        std::coroutine_handle<> pop_injected()
+        {
+            if (!has_injected_work_.load(std::memory_order_relaxed))
+                return nullptr;
+
+            std::lock_guard lk{injection_mtx_};
+            if (injection_queue_.empty())
+                return nullptr;
+
+            auto handle = injection_queue_.front();
+            injection_queue_.pop_front();
+            has_injected_work_.store(!injection_queue_.empty(), std::memory_order_relaxed);
+
+            return handle;
+        }
+
+        std::coroutine_handle<> find_work(std::size_t index, std::minstd_rand& rnd)
+        {
+            if (auto handle = queues_[index]->pop())
+                return handle;
+
+            if (auto handle = pop_injected())
+                return handle;
+
+            const std::size_t count = queues_.size();
+            const std::size_t first_victim = rnd() % count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t victim = (first_victim + i) % count;
+                if (victim == index)
+                    continue;
+
+                if (auto handle = queues_[victim]->steal())
+                    return handle;
+            }
+
+            return nullptr;
+        }
+
+        void run_worker(std::size_t index)
+        {
+            current_worker() = WorkerContext{this, index};
+            std::minstd_rand rnd{static_cast<std::uint32_t>(index + 1)};
+
+            while (true)
+            {
+                if (auto handle = find_work(index, rnd))
+                {
+                    handle.resume();
+                    continue;
+                }
+
+                const auto epoch = wake_epoch_.load(std::memory_order_seq_cst);
+                sleeping_.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in wake_up
+
+                if (auto handle = find_work(index, rnd)) // recheck after announcing sleep
+                {
+                    sleeping_.fetch_sub(1, std::memory_order_seq_cst);
+                    handle.resume();
+                    continue;
+                }
+
+                if (stop_requested_.load())
+                {
+                    sleeping_.fetch_sub(1, std::memory_order_seq_cst);
+                    break;
+                }
+
+                wake_epoch_.wait(epoch, std::memory_order_seq_cst);
+                sleeping_.fetch_sub(1, std::memory_order_seq_cst);
+            }
+
+            current_worker() = WorkerContext{};
+        }
+    };
+
+    // calls task(index) for every index in [0, count) on the workers and the calling thread
+    // - returns when all calls have finished, rethrows the first exception (the remaining indexes are skipped)
+    // - the caller never waits for a job that has not started, so it may be called from the pool's own workers
+    //   (jobs picked up late find no work and only touch the shared state)
+    template <typename TTask>
+    void parallel_for(ThreadPool& pool, std::size_t count, TTask&& task)
+    {
+        struct SharedState
+        {
+            std::atomic<std::size_t> next_index{0};
+            std::latch completed;
+            std::atomic<bool> failed{false};
+            std::mutex exception_mtx;
+            std::exception_ptr exception;
+
+            explicit SharedState(std::size_t count)
+                : completed{static_cast<std::ptrdiff_t>(count)}
+            { }
+        };
+
+        if (count == 0)
+            return;
+
+        auto state = std::make_shared<SharedState>(count);
+
+        auto work = [state, &task, count] {
+            for (std::size_t index; (index = state->next_index.fetch_add(1, std::memory_order_relaxed)) < count;)
+            {
+                if (!state->failed.load(std::memory_order_relaxed))
+                {
+                    try
+                    {
+                        task(index);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard lk{state->exception_mtx};
+                        if (!state->exception)
+                            state->exception = std::current_exception();
+                        state->failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+
+                state->completed.count_down();
+            }
+        };
+
+        const std::size_t helper_count = std::min(pool.size(), count - 1);
+        for (std::size_t i = 0; i < helper_count; ++i)
+            pool.submit(work);
+
+        work();
+        state->completed.wait();
+
+        if (state->exception)
+            std::rethrow_exception(state->exception);
+    }
+} // namespace helpers
+
+#endif
@@ -0,0 +1,311 @@
+#include <catch2/catch_test_macros.hpp>
+#include <dataset_cache.hpp>
+#include <helpers.hpp>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std::literals;
+
+constexpr auto first_values_of_lane(uint64_t seed, uint64_t stream)
+{
+    helpers::random::PCG rng{seed, stream};
+
+    std::array<uint32_t, 4> values{};
+    std::ranges::generate(values, rng);
+
+    return values;
+}
+
+TEST_CASE("multi-stream PCG")
+{
+    SECTION("lane k produces the sequence of PCG{seed, k}")
+    {
+        helpers::random::PCGx8 rng{42};
+
+        std::vector<uint32_t> values(8 * 100);
+        rng.fill(values);
+
+        for (uint64_t lane = 0; lane < 8; ++lane)
+        {
+            helpers::random::PCG lane_rng{42, lane};
+
+            for (size_t i = lane; i < values.size(); i += 8)
+                REQUIRE(values[i] == lane_rng());
+        }
+    }
+
+    SECTION("output does not depend on chunking")
+    {
+        helpers::random::PCGx4 rng_bulk{665};
+        std::vector<uint32_t> bulk(1001);
+        rng_bulk.fill(bulk);
+
+        helpers::random::PCGx4 rng_chunked{665};
+        std::vector<uint32_t> chunked(bulk.size());
+        std::span chunks{chunked};
+        rng_chunked.fill(chunks.subspan(0, 3));
+        rng_chunked.fill(chunks.subspan(3, 500));
+        std::ranges::generate(chunks.subspan(503, 10), std::ref(rng_chunked));
+        rng_chunked.fill(chunks.subspan(513));
+
+        CHECK(bulk == chunked);
+    }
+
+    SECTION("constexpr evaluation")
+    {
+        constexpr auto lane_values = [] {
+            helpers::random::PCGx4 rng{7};
+            std::array<uint32_t, 16> values{};
+            rng.fill(values);
+            return values;
+        }();
+
+        constexpr auto expected = first_values_of_lane(7, 2);
+
+        static_assert(lane_values[2] == expected[0]);
+        static_assert(lane_values[6] == expected[1]);
+        static_assert(lane_values[14] == expected[3]);
+    }
+}
+
+TEST_CASE("PCG - jump-ahead & streams")
+{
+    SECTION("advance(n) is equivalent to n calls")
+    {
+        helpers::random::PCG stepped{42, 3};
+        for (int i = 0; i < 1'000; ++i)
+            stepped();
+
+        helpers::random::PCG jumped{42, 3};
+        jumped.advance(1'000);
+
+        CHECK(jumped() == stepped());
+    }
+
+    SECTION("advance is constexpr")
+    {
+        static_assert([] {
+            helpers::random::PCG stepped{665};
+            for (int i = 0; i < 100; ++i)
+                stepped();
+
+            helpers::random::PCG jumped{665};
+            jumped.advance(100);
+
+            return jumped() == stepped();
+        }());
+    }
+
+    SECTION("split streams are distinct and reproducible")
+    {
+        helpers::random::PCG rng{42};
+
+        auto stream_1 = rng.split(1);
+        auto stream_2 = rng.split(2);
+        auto stream_1_again = rng.split(1);
+
+        CHECK(stream_1() != stream_2());
+        CHECK(stream_1_again() == helpers::random::PCG{42}.split(1)());
+    }
+
+    SECTION("parallel generate_n is bit-identical to sequential generation")
+    {
+        std::vector<uint32_t> sequential(1'000'003);
+        helpers::random::PCG sequential_rng{42};
+        std::ranges::generate(sequential, std::ref(sequential_rng));
+
+        std::vector<uint32_t> parallel(sequential.size());
+        helpers::random::PCG parallel_rng{42};
+        helpers::random::generate_n(parallel_rng, parallel, 4);
+
+        CHECK(parallel == sequential);
+        CHECK(parallel_rng() == sequential_rng());
+    }
+}
+
+TEST_CASE("numeric datasets")
+{
+    SECTION("compile-time and runtime datasets are identical")
+    {
+        constexpr auto compile_time_data = helpers::create_numeric_dataset<100>(42);
+        const auto runtime_data = helpers::create_numeric_dataset<100>(42);
+
+        CHECK(std::ranges::equal(compile_time_data, runtime_data));
+        CHECK(std::ranges::equal(compile_time_data, helpers::create_numeric_dataset(100, 42)));
+    }
+
+    SECTION("values are in range [low; high)")
+    {
+        constexpr auto data = helpers::create_numeric_dataset<1000>(665, -10, 10);
+
+        CHECK(std::ranges::all_of(data, [](int x) { return -10 <= x && x < 10; }));
+    }
+
+    SECTION("large datasets - output does not depend on thread count")
+    {
+        const size_t size = 5 * helpers::dataset_block_size + 17;
+
+        auto data = helpers::create_numeric_dataset(size, 7);
+
+        std::vector<int> single_threaded(size);
+        helpers::fill_numeric_dataset(single_threaded, 7, -100, 100, 1);
+
+        std::vector<int> multi_threaded(size);
+        helpers::fill_numeric_dataset(multi_threaded, 7, -100, 100, 3);
+
+        CHECK(data == single_threaded);
+        CHECK(data == multi_threaded);
+    }
+}
+
+TEST_CASE("distributions")
+{
+    namespace rnd = helpers::random;
+
+    SECTION("bounded integers are unbiased and in range")
+    {
+        rnd::PCG rng{42};
+        rnd::uniform_int_distribution<int> distr{-3, 3};
+
+        std::array<int, 7> histogram{};
+        for (int i = 0; i < 70'000; ++i)
+        {
+            int value = distr(rng);
+            REQUIRE((-3 <= value && value <= 3));
+            ++histogram[value + 3];
+        }
+
+        CHECK(std::ranges::all_of(histogram, [](int count) { return 9'000 < count && count < 11'000; }));
+    }
+
+    SECTION("full 32-bit range")
+    {
+        rnd::PCG rng{42};
+        rnd::PCG reference{42};
+
+        CHECK(rnd::uniform_int_distribution<uint32_t>{}(rng) == reference());
+    }
+
+    SECTION("normal distribution")
+    {
+        auto data = helpers::create_numeric_dataset(100'000, 42, rnd::normal_distribution<double>{10.0, 2.0});
+
+        double mean = std::accumulate(data.begin(), data.end(), 0.0) / data.size();
+        double variance = std::accumulate(data.begin(), data.end(), 0.0, [mean](double acc, double x) { return acc + (x - mean) * (x - mean); }) / data.size();
+
+        CHECK(std::abs(mean - 10.0) < 0.05);
+        CHECK(std::abs(variance - 4.0) < 0.1);
+    }
+
+    SECTION("zipf distribution is skewed towards small values")
+    {
+        auto data = helpers::create_numeric_dataset(100'000, 42, rnd::zipf_distribution<int>{1'000, 1.2});
+
+        CHECK(std::ranges::all_of(data, [](int x) { return 1 <= x && x <= 1'000; }));
+
+        auto ones = std::ranges::count(data, 1);
+        auto twos = std::ranges::count(data, 2);
+        CHECK(ones > 2 * twos * 0.9);
+        CHECK(ones > 20'000);
+    }
+
+    SECTION("constexpr datasets with patterns")
+    {
+        constexpr auto sorted = helpers::create_numeric_dataset<500>(42, rnd::uniform_int_distribution<int>{0, 1000}, rnd::Pattern::sorted);
+        static_assert(std::ranges::is_sorted(sorted));
+
+        constexpr auto normal = helpers::create_numeric_dataset<500>(42, rnd::normal_distribution<double>{});
+        const auto runtime_normal = helpers::create_numeric_dataset<500>(42, rnd::normal_distribution<double>{});
+        CHECK(std::ranges::equal(normal, runtime_normal));
+
+        auto few_unique = helpers::create_numeric_dataset(10'000, 42, rnd::uniform_int_distribution<int>{}, rnd::Pattern::few_unique);
+        std::ranges::sort(few_unique);
+        CHECK(std::ranges::distance(few_unique.begin(), std::unique(few_unique.begin(), few_unique.end())) <= 16);
+    }
+}
+
+TEST_CASE("dataset cache")
+{
+    namespace cache = helpers::cache;
+
+    const auto cache_dir = std::filesystem::temp_directory_path() / ("helpers-dataset-cache-" + std::to_string(::getpid()));
+    std::filesystem::remove_all(cache_dir);
+
+    cache::DatasetCache dataset_cache{cache_dir};
+
+    SECTION("generated data is persisted and mapped back")
+    {
+        auto data = dataset_cache.get_numeric_dataset(100'000, 42);
+
+        CHECK(std::ranges::equal(data, helpers::create_numeric_dataset(100'000, 42)));
+        CHECK(std::filesystem::exists(dataset_cache.file_path(cache::DatasetKey{.seed = 42, .size = 100'000})));
+    }
+
+    SECTION("cached data is not regenerated")
+    {
+        cache::DatasetKey key{.seed = 7, .size = 1'000, .distribution = "iota"};
+        int generator_calls = 0;
+        auto iota = [&](std::span<int> data) { ++generator_calls; std::iota(data.begin(), data.end(), 0); };
+
+        auto first = dataset_cache.get_or_create<int>(key, iota);
+        auto second = dataset_cache.get_or_create<int>(key, iota);
+
+        CHECK(generator_calls == 1);
+        CHECK(std::ranges::equal(first, second));
+        CHECK(second[999] == 999);
+    }
+
+    SECTION("corrupted file fails checksum validation and is regenerated")
+    {
+        cache::DatasetKey key{.seed = 7, .size = 1'000, .distribution = "iota"};
+        auto iota = [](std::span<int> data) { std::iota(data.begin(), data.end(), 0); };
+
+        dataset_cache.get_or_create<int>(key, iota);
+
+        {
+            std::fstream file{dataset_cache.file_path(key), std::ios::in | std::ios::out | std::ios::binary};
+            file.seekp(4096 + 10 * sizeof(int));
+            int garbage = 665;
+            file.write(reinterpret_cast<const char*>(&garbage), sizeof(garbage));
+        }
+
+        CHECK_FALSE(dataset_cache.find<int>(key).has_value());
+        CHECK(dataset_cache.find<int>(key, cache::Validation::header_only).has_value());
+
+        auto regenerated = dataset_cache.get_or_create<int>(key, iota);
+        CHECK(regenerated[10] == 10);
+    }
+
+    SECTION("data of another element type with the same key is not mapped")
+    {
+        cache::DatasetKey key{.seed = 7, .size = 1'000, .distribution = "iota"};
+
+        dataset_cache.get_or_create<int>(key, [](std::span<int> data) { std::iota(data.begin(), data.end(), 0); });
+
+        CHECK_FALSE(dataset_cache.find<float>(key).has_value());
+        CHECK_FALSE(dataset_cache.find<unsigned>(key).has_value());
+
+        auto floats = dataset_cache.get_or_create<float>(key, [](std::span<float> data) { std::iota(data.begin(), data.end(), 0.5f); });
+        CHECK(floats[10] == 10.5f);
+    }
+
+    SECTION("a failing generator leaves no file behind")
+    {
+        cache::DatasetKey key{.seed = 7, .size = 1'000, .distribution = "throwing"};
+        auto failing = [](std::span<int>) { throw std::runtime_error("generator failed"); };
+
+        CHECK_THROWS_AS(dataset_cache.get_or_create<int>(key, failing), std::runtime_error);
+        CHECK(std::filesystem::is_empty(cache_dir));
+    }
+
+    std::filesystem::remove_all(cache_dir);
+}
@@ -0,0 +1,109 @@
+#include "memoize.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <ranges>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    // stands in for a costly parser
+    struct CountingParser
+    {
+        int* calls;
+
+        int operator()(const std::string& text) const
+        {
+            ++*calls;
+            return std::stoi(text);
+        }
+    };
+
+    bool is_even(int n)
+    {
+        return n % 2 == 0;
+    }
+
+    // the const& overload set of printing.cpp - views::filter is not iterable through const&
+    std::vector<int> collect(const auto& rng)
+    {
+        std::vector<int> result;
+        for (const auto& item : rng)
+            result.push_back(item);
+        return result;
+    }
+}
+
+TEST_CASE("cache_latest - dereferences are computed once")
+{
+    const std::vector<std::string> lines{"1", "2", "3", "4", "5", "6"};
+    int calls = 0;
+
+    SECTION("transform | filter - the predicate and the loop share the result")
+    {
+        auto evens = lines | std::views::transform(CountingParser{&calls}) | std::views::filter(is_even);
+        CHECK(collect(std::vector(evens.begin(), evens.end())) == std::vector{2, 4, 6});
+        CHECK(calls == 9);
+    }
+
+    SECTION("transform | cache_latest | filter")
+    {
+        auto evens = lines | std::views::transform(CountingParser{&calls}) | RangesExt::cache_latest | std::views::filter(is_even);
+
+        std::vector<int> result;
+        for (int n : evens)
+            result.push_back(n);
+
+        CHECK(result == std::vector{2, 4, 6});
+        CHECK(calls == 6);
+    }
+
+    SECTION("references are not copied")
+    {
+        std::vector<std::string> words{"a", "b"};
+        auto cached = words | RangesExt::cache_latest;
+
+        for (auto& word : cached)
+            word += "!";
+
+        CHECK(words == std::vector{"a!"s, "b!"s});
+    }
+}
+
+TEST_CASE("memoize - filter | transform | memoize | reverse")
+{
+    const std::vector<std::string> lines{"1", "2", "3", "4", "5", "6"};
+    int calls = 0;
+
+    auto parsed = lines | std::views::filter([](const std::string& line) { return line != "3"; })
+        | std::views::transform(CountingParser{&calls})
+        | RangesExt::memoize;
+
+    auto reversed = parsed | std::views::reverse;
+
+    CHECK(std::vector(reversed.begin(), reversed.end()) == std::vector{6, 5, 4, 2, 1});
+    CHECK(std::vector(reversed.begin(), reversed.end()) == std::vector{6, 5, 4, 2, 1});
+    CHECK(collect(parsed) == std::vector{1, 2, 4, 5, 6});
+    CHECK(calls == 5);
+}
+
+TEST_CASE("memoize - elements are computed on demand")
+{
+    int calls = 0;
+    auto squares = std::views::iota(1) | std::views::transform([&calls](int n) { ++calls; return n * n; }) | RangesExt::memoize;
+
+    static_assert(std::ranges::random_access_range<decltype(squares)>);
+
+    CHECK(squares[9] == 100);
+    CHECK(squares.cached_count() == 10);
+
+    auto first_three = squares | std::views::take(3);
+    CHECK(collect(first_three) == std::vector{1, 4, 9});
+    CHECK(calls == 10);
+
+    const auto copy = squares; // copies share the cache
+    CHECK(copy[4] == 25);
+    CHECK(calls == 10);
+}
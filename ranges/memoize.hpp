@@ -0,0 +1,339 @@
+#ifndef MEMOIZE_HPP
+#define MEMOIZE_HPP
+
+#include "pipeable.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// views computing every element of the underlying view at most once
+//
+//   auto parsed = lines | views::filter(is_record) | views::transform(parse) | RangesExt::memoize;
+//   for (const auto& record : parsed | views::reverse) ... // parse runs once per record, however often it is traversed
+//
+//   auto valid = lines | views::transform(parse) | RangesExt::cache_latest | views::filter(is_valid);
+//   // without cache_latest parse would run twice for every valid line - in the predicate and on dereference
+namespace RangesExt
+{
+    namespace detail
+    {
+        // optional that is not copied together with its owner - copies of a view start with an empty cache
+        template <typename T>
+        class NonPropagatingCache : public std::optional<T>
+        {
+        public:
+            NonPropagatingCache() = default;
+
+            NonPropagatingCache(const NonPropagatingCache&) noexcept
+            { }
+
+            NonPropagatingCache(NonPropagatingCache&& other) noexcept
+            {
+                other.reset();
+            }
+
+            NonPropagatingCache& operator=(const NonPropagatingCache& other) noexcept
+            {
+                if (this != &other)
+                    this->reset();
+                return *this;
+            }
+
+            NonPropagatingCache& operator=(NonPropagatingCache&& other) noexcept
+            {
+                this->reset();
+                other.reset();
+                return *this;
+            }
+        };
+    } // namespace detail
+
+    // input view caching the result of dereferencing the current element (C++26 views::cache_latest)
+    // - the element is computed once no matter how often the iterator is dereferenced
+    template <std::ranges::input_range V>
+        requires std::ranges::view<V>
+    class CacheLatestView : public std::ranges::view_interface<CacheLatestView<V>>
+    {
+        using Reference = std::ranges::range_reference_t<V>;
+        // references are cached as pointers, prvalues by value
+        using Cached = std::conditional_t<std::is_reference_v<Reference>, std::add_pointer_t<Reference>, Reference>;
+
+    public:
+        class Sentinel;
+
+        class Iterator
+        {
+        public:
+            using value_type = std::ranges::range_value_t<V>;
+            using difference_type = std::ranges::range_difference_t<V>;
+            using iterator_concept = std::input_iterator_tag;
+
+            Iterator(Iterator&&) = default;
+            Iterator& operator=(Iterator&&) = default;
+
+            Reference& operator*() const
+            {
+                auto& cache = parent_->cache_;
+
+                if constexpr (std::is_reference_v<Reference>)
+                {
+                    if (!cache)
+                        cache.emplace(std::addressof(static_cast<Reference&>(*current_)));
+                    return **cache;
+                }
+                else
+                {
+                    if (!cache)
+                        cache.emplace(*current_);
+                    return *cache;
+                }
+            }
+
+            Iterator& operator++()
+            {
+                ++current_;
+                parent_->cache_.reset();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const Iterator& it, const Sentinel& sentinel)
+            {
+                return it.is_at(sentinel);
+            }
+
+        private:
+            friend class CacheLatestView;
+
+            CacheLatestView* parent_;
+            std::ranges::iterator_t<V> current_;
+
+            bool is_at(const Sentinel& sentinel) const
+            {
+                return current_ == sentinel.end_;
+            }
+
+            explicit Iterator(CacheLatestView& parent)
+                : parent_{&parent}
+                , current_{std::ranges::begin(parent.base_)}
+            { }
+        };
+
+        class Sentinel
+        {
+        public:
+            Sentinel() = default;
+
+        private:
+            friend class CacheLatestView;
+            friend class Iterator;
+
+            std::ranges::sentinel_t<V> end_{};
+
+            explicit Sentinel(CacheLatestView& parent)
+                : end_{std::ranges::end(parent.base_)}
+            { }
+        };
+
+        CacheLatestView() requires std::default_initializable<V> = default;
+
+        explicit CacheLatestView(V base)
+            : base_{std::move(base)}
+        { }
+
+        V base() const& requires std::copy_constructible<V> { return base_; }
+        V base() && { return std::move(base_); }
+
+        Iterator begin() { return Iterator{*this}; }
+        Sentinel end() { return Sentinel{*this}; }
+
+        auto size() requires std::ranges::sized_range<V> { return std::ranges::size(base_); }
+        auto size() const requires std::ranges::sized_range<const V> { return std::ranges::size(base_); }
+
+    private:
+        V base_ = V();
+        detail::NonPropagatingCache<Cached> cache_;
+    };
+
+    template <typename TRange>
+    CacheLatestView(TRange&&) -> CacheLatestView<std::views::all_t<TRange>>;
+
+    // random-access view materializing the underlying view on demand - every element is computed once
+    // and kept until the last copy of the view is gone
+    // - copies share the cache, so the view may be iterated through const& and traversed many times (e.g. reversed)
+    // - not synchronized - a memoized view must not be iterated by many threads at once
+    template <std::ranges::input_range V>
+        requires std::ranges::view<V>
+    class MemoizeView : public std::ranges::view_interface<MemoizeView<V>>
+    {
+        using Value = std::remove_cvref_t<std::ranges::range_reference_t<V>>;
+
+        struct State
+        {
+            V base;
+            std::optional<std::ranges::iterator_t<V>> current;
+            std::deque<Value> items; // references stay valid while the deque grows
+
+            // true if the element at index exists
+            bool fill_to(std::size_t index)
+            {
+                if (!current)
+                    current.emplace(std::ranges::begin(base));
+
+                while (items.size() <= index && *current != std::ranges::end(base))
+                {
+                    items.emplace_back(**current);
+                    ++*current;
+                }
+
+                return index < items.size();
+            }
+        };
+
+    public:
+        class Iterator
+        {
+        public:
+            using value_type = Value;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+
+            Iterator() = default;
+
+            const Value& operator*() const
+            {
+                state_->fill_to(index());
+                return state_->items[index()];
+            }
+
+            const Value& operator[](difference_type offset) const
+            {
+                return *(*this + offset);
+            }
+
+            Iterator& operator++() noexcept
+            {
+                ++index_;
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                auto it = *this;
+                ++index_;
+                return it;
+            }
+
+            Iterator& operator--() noexcept
+            {
+                --index_;
+                return *this;
+            }
+
+            Iterator operator--(int) noexcept
+            {
+                auto it = *this;
+                --index_;
+                return it;
+            }
+
+            Iterator& operator+=(difference_type offset) noexcept
+            {
+                index_ += offset;
+                return *this;
+            }
+
+            Iterator& operator-=(difference_type offset) noexcept
+            {
+                index_ -= offset;
+                return *this;
+            }
+
+            friend Iterator operator+(Iterator it, difference_type offset) noexcept { return it += offset; }
+            friend Iterator operator+(difference_type offset, Iterator it) noexcept { return it += offset; }
+            friend Iterator operator-(Iterator it, difference_type offset) noexcept { return it -= offset; }
+            friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index_ - rhs.index_; }
+
+            friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index_ == rhs.index_; }
+            friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.index_ <=> rhs.index_; }
+
+            // reaching the end computes the elements up to it
+            friend bool operator==(const Iterator& it, std::default_sentinel_t)
+            {
+                return !it.state_->fill_to(it.index());
+            }
+
+        private:
+            friend class MemoizeView;
+
+            State* state_ = nullptr;
+            difference_type index_ = 0;
+
+            explicit Iterator(State& state) noexcept
+                : state_{&state}
+            { }
+
+            std::size_t index() const noexcept { return static_cast<std::size_t>(index_); }
+        };
+
+        MemoizeView() requires std::default_initializable<V>
+            : MemoizeView{V()}
+        { }
+
+        explicit MemoizeView(V base)
+            : state_{std::make_shared<State>(State{std::move(base), std::nullopt, {}})}
+        { }
+
+        Iterator begin() const { return Iterator{*state_}; }
+        std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+        // number of elements computed so far
+        std::size_t cached_count() const noexcept { return state_->items.size(); }
+
+    private:
+        std::shared_ptr<State> state_;
+    };
+
+    template <typename TRange>
+    MemoizeView(TRange&&) -> MemoizeView<std::views::all_t<TRange>>;
+
+    struct CacheLatestFn : Pipeable<CacheLatestFn>
+    {
+        template <std::ranges::viewable_range TRange>
+            requires std::ranges::input_range<TRange>
+        auto operator()(TRange&& range) const
+        {
+            return CacheLatestView{std::forward<TRange>(range)};
+        }
+    };
+
+    struct MemoizeFn : Pipeable<MemoizeFn>
+    {
+        template <std::ranges::viewable_range TRange>
+            requires std::ranges::input_range<TRange>
+        auto operator()(TRange&& range) const
+        {
+            return MemoizeView{std::forward<TRange>(range)};
+        }
+    };
+
+    // rng | cache_latest
+    inline constexpr CacheLatestFn cache_latest;
+
+    // rng | memoize
+    inline constexpr MemoizeFn memoize;
+} // namespace RangesExt
+
+#endif
@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+#include <merge.hpp>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    // sorted shards with duplicates inside and across the shards, some of them empty
+    std::vector<std::vector<int>> sorted_shards(size_t shard_count, size_t max_size)
+    {
+        std::mt19937 rnd{665};
+
+        std::vector<std::vector<int>> shards(shard_count);
+        for (auto& shard : shards)
+        {
+            shard.resize(rnd() % (max_size + 1));
+            std::ranges::generate(shard, [&] { return static_cast<int>(rnd() % 1000); });
+            std::ranges::sort(shard);
+        }
+        return shards;
+    }
+
+    std::vector<int> concatenated(const std::vector<std::vector<int>>& shards)
+    {
+        std::vector<int> result;
+        for (const auto& shard : shards)
+            result.insert(result.end(), shard.begin(), shard.end());
+        return result;
+    }
+
+    constexpr int sum_of_union()
+    {
+        std::array odd = {1, 3, 5, 7, 9};
+        std::array small = {1, 2, 3};
+        std::array even = {2, 4, 6, 8};
+
+        int sum = 0;
+        for (int item : helpers::merging::merge_unique(helpers::merging::runs_of(odd, small, even)))
+            sum += item;
+        return sum;
+    }
+}
+
+TEST_CASE("branchless_merge")
+{
+    std::mt19937 rnd{42};
+
+    std::vector<std::pair<int, char>> first(1000);
+    std::vector<std::pair<int, char>> second(700);
+    std::ranges::generate(first, [&] { return std::pair{static_cast<int>(rnd() % 100), 'a'}; });
+    std::ranges::generate(second, [&] { return std::pair{static_cast<int>(rnd() % 100), 'b'}; });
+    std::ranges::sort(first);
+    std::ranges::sort(second);
+
+    auto by_key = [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; };
+
+    std::vector<std::pair<int, char>> expected;
+    std::ranges::merge(first, second, std::back_inserter(expected), by_key);
+
+    std::vector<std::pair<int, char>> result(first.size() + second.size());
+    CHECK(helpers::merging::branchless_merge(first, second, result.begin(), by_key) == result.end());
+    CHECK(result == expected); // stable - ties are taken from the first run
+}
+
+TEST_CASE("merge_to - k sorted runs")
+{
+    for (size_t shard_count : {0, 1, 2, 3, 7, 16})
+    {
+        const auto shards = sorted_shards(shard_count, 200);
+
+        auto expected = concatenated(shards);
+        std::ranges::sort(expected);
+
+        std::vector<int> result;
+        helpers::merging::merge_to(shards, std::back_inserter(result));
+        CHECK(result == expected);
+    }
+
+    SECTION("descending runs")
+    {
+        std::vector<std::vector<std::string>> runs = {{"c", "b", "a"}, {"d", "b"}, {}, {"e", "a"}};
+
+        std::vector<std::string> result;
+        helpers::merging::merge_to(runs, std::back_inserter(result), std::greater{});
+        CHECK(result == std::vector{"e"s, "d"s, "c"s, "b"s, "b"s, "a"s, "a"s});
+    }
+}
+
+TEST_CASE("merge & merge_unique - lazy views")
+{
+    const auto shards = sorted_shards(9, 300);
+
+    auto expected = concatenated(shards);
+    std::ranges::sort(expected);
+
+    SECTION("merge")
+    {
+        auto merged = helpers::merging::merge(shards);
+        CHECK(std::ranges::equal(merged, expected));
+    }
+
+    SECTION("merge_unique")
+    {
+        expected.erase(std::ranges::unique(expected).begin(), expected.end());
+
+        auto merged = helpers::merging::merge_unique(shards);
+        CHECK(std::ranges::equal(merged, expected));
+    }
+
+    SECTION("a prefix of the union")
+    {
+        std::vector<std::vector<int>> runs = {{1, 4, 9}, {1, 2, 3, 100}};
+
+        auto first_three = helpers::merging::merge_unique(runs) | std::views::take(3);
+        CHECK(std::ranges::equal(first_three, std::vector{1, 2, 3}));
+    }
+
+    SECTION("runs of different types")
+    {
+        const std::array small = {1, 5, 10};
+        const std::vector large = {2, 5, 7, 10, 12};
+
+        auto merged = helpers::merging::merge_unique(helpers::merging::runs_of(small, large));
+        CHECK(std::ranges::equal(merged, std::vector{1, 2, 5, 7, 10, 12}));
+    }
+}
+
+TEST_CASE("merge_unique - constexpr")
+{
+    static_assert(sum_of_union() == 45);
+}
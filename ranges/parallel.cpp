@@ -0,0 +1,139 @@
+#include "parallel.hpp"
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <latch>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    bool is_even(int n)
+    {
+        return n % 2 == 0;
+    }
+
+    long long square(int n)
+    {
+        return static_cast<long long>(n) * n;
+    }
+}
+
+TEST_CASE("par_to - keeps the order of the sequential pipeline")
+{
+    helpers::ThreadPool pool{4};
+
+    const auto stages = std::views::filter(is_even) | std::views::transform(square);
+    auto numbers = std::views::iota(0, 1'000'000);
+
+    auto parallel = numbers | RangesExt::par_to<std::vector>(pool, stages);
+
+    std::vector<long long> sequential;
+    std::ranges::copy(numbers | stages, std::back_inserter(sequential));
+
+    CHECK(parallel == sequential);
+}
+
+TEST_CASE("par_to - sources")
+{
+    helpers::ThreadPool pool{2};
+
+    SECTION("vector")
+    {
+        std::vector<std::string> words(10'000, "word");
+        auto lengths = words | RangesExt::par_to<std::vector>(pool, std::views::transform(&std::string::size));
+
+        CHECK(lengths.size() == 10'000);
+        CHECK(std::ranges::all_of(lengths, [](size_t length) { return length == 4; }));
+    }
+
+    SECTION("sized - not random-access")
+    {
+        std::list<int> numbers(5'000);
+        std::iota(numbers.begin(), numbers.end(), 0);
+
+        auto result = numbers | RangesExt::par_to<std::vector>(pool);
+        CHECK(std::ranges::equal(result, numbers));
+    }
+
+    SECTION("random-access with a sized sentinel")
+    {
+        auto result = std::views::iota(1) | std::views::take(20) | RangesExt::par_to<std::vector>(pool, std::views::filter(is_even));
+        CHECK(result == std::vector{2, 4, 6, 8, 10, 12, 14, 16, 18, 20});
+    }
+
+    SECTION("empty")
+    {
+        CHECK((std::vector<int>{} | RangesExt::par_to<std::vector>(pool)).empty());
+    }
+}
+
+TEST_CASE("par_reduce")
+{
+    helpers::ThreadPool pool{4};
+
+    auto numbers = std::views::iota(0, 1'000'000);
+
+    CHECK((numbers | RangesExt::par_reduce(pool, 0LL)) == 499'999'500'000LL);
+    CHECK((numbers | RangesExt::par_reduce(pool, 0LL, std::plus{}, std::views::filter(is_even) | std::views::transform(square))) == 166'666'166'667'000'000LL);
+
+    SECTION("operation does not have to be commutative")
+    {
+        auto letters = std::views::iota(0, 26'000) | std::views::transform([](int i) { return std::string(1, static_cast<char>('a' + i / 1000)); });
+
+        const auto text = letters | RangesExt::par_reduce(pool, ">"s);
+
+        REQUIRE(text.size() == 26'001);
+        CHECK(std::ranges::is_sorted(text.substr(1)));
+    }
+}
+
+TEST_CASE("par_for_each - chunks are processed concurrently")
+{
+    helpers::ThreadPool pool{1};
+
+    std::atomic<long long> sum = 0;
+    std::latch first_and_last{2};
+
+    std::views::iota(0, 1'000'000) | RangesExt::par_for_each(pool, [&](int n) {
+        sum += n;
+        if (n == 0 || n == 999'999)
+            first_and_last.arrive_and_wait(); // deadlocks unless the first and the last chunk are processed by two threads
+    });
+
+    CHECK(sum == 499'999'500'000LL);
+}
+
+TEST_CASE("par_for_each - exception is rethrown on the calling thread")
+{
+    helpers::ThreadPool pool{2};
+
+    auto fail_on_42 = [](int n) {
+        if (n == 42'000)
+            throw std::runtime_error{"42"};
+    };
+
+    CHECK_THROWS_WITH(std::views::iota(0, 100'000) | RangesExt::par_for_each(pool, fail_on_42), "42");
+}
+
+TEST_CASE("par_reduce - nested inside a job of the same pool")
+{
+    helpers::ThreadPool pool{1};
+    std::atomic<long long> result = 0;
+    std::atomic<bool> done = false;
+
+    pool.submit([&] {
+        result = std::views::iota(0, 100'000) | RangesExt::par_reduce(pool, 0LL);
+        done = true;
+        done.notify_one();
+    });
+
+    done.wait(false);
+    CHECK(result == 4'999'950'000LL);
+}
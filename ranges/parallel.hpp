@@ -0,0 +1,233 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include "pipeable.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <thread_pool.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// parallel execution of view pipelines on helpers::ThreadPool
+//
+//   auto stages = std::views::filter(is_prime) | std::views::transform(square);
+//   auto squares = std::views::iota(0, 100'000'000) | RangesExt::par_to<std::vector>(pool, stages);
+//
+// - the source is split into chunks, the stages are applied to every chunk separately
+//   (a composed view cannot be split after a filter - hence the stages are passed to the adapter)
+// - the calling thread processes chunks too, so the adapters may be used from inside the pool's own workers
+namespace RangesExt
+{
+    // a chunk of source elements should fit in L1d, so all stages run over it while it is cache-resident
+    inline constexpr std::size_t chunk_bytes = 32 * 1024;
+
+    // below this many elements the scheduling overhead outweighs the work
+    inline constexpr std::size_t min_chunk_size = 1024;
+
+    // sources that can be split into chunks - random-access and sized sources are split without visiting their elements,
+    // other forward ranges (e.g. iota(1) | take(20)) need one pass over the iterators first
+    template <typename TRange>
+    concept ChunkableRange = std::ranges::forward_range<TRange>;
+
+    namespace detail
+    {
+        using AllStages = std::remove_cvref_t<decltype(std::views::all)>;
+
+        template <typename TRange>
+        using Chunk = std::ranges::subrange<std::ranges::iterator_t<TRange>>;
+
+        template <typename TStages, typename TRange>
+        using StagesResult = std::invoke_result_t<const TStages&, Chunk<TRange>&>;
+
+        inline std::size_t chunk_size_for(std::size_t size, std::size_t value_size, std::size_t thread_count)
+        {
+            const std::size_t cache_sized = std::max<std::size_t>(chunk_bytes / value_size, 1);
+            const std::size_t balanced = size / (4 * thread_count); // a few chunks per thread evens out skewed stages
+            return std::min(cache_sized, std::max(balanced, min_chunk_size));
+        }
+
+        template <typename TRange>
+        std::vector<Chunk<TRange>> split_into_chunks(TRange& range, std::size_t thread_count)
+        {
+            const auto size = static_cast<std::size_t>(std::ranges::distance(range));
+            const auto chunk_size = chunk_size_for(size, sizeof(std::ranges::range_value_t<TRange>), thread_count);
+
+            std::vector<Chunk<TRange>> chunks;
+            chunks.reserve((size + chunk_size - 1) / chunk_size);
+
+            auto first = std::ranges::begin(range);
+            for (std::size_t offset = 0; offset < size; offset += chunk_size)
+            {
+                auto last = std::ranges::next(first, static_cast<std::ranges::range_difference_t<TRange>>(std::min(chunk_size, size - offset)));
+                chunks.emplace_back(first, last);
+                first = last;
+            }
+
+            return chunks;
+        }
+    } // namespace detail
+
+    // calls function(item) for every item of the pipeline - concurrently and in no particular order
+    template <typename TFunction, typename TStages>
+    class ParForEach : public Pipeable<ParForEach<TFunction, TStages>>
+    {
+    public:
+        ParForEach(helpers::ThreadPool& pool, TFunction function, TStages stages)
+            : pool_{&pool}
+            , function_{std::move(function)}
+            , stages_{std::move(stages)}
+        { }
+
+        template <ChunkableRange TRange>
+            requires std::ranges::input_range<detail::StagesResult<TStages, TRange>>
+        void operator()(TRange&& range) const
+        {
+            const auto chunks = detail::split_into_chunks(range, pool_->size() + 1);
+
+            auto process_chunk = [&](std::size_t index) {
+                auto chunk = chunks[index];
+                for (auto&& item : std::invoke(stages_, chunk))
+                    std::invoke(function_, std::forward<decltype(item)>(item));
+            };
+
+            helpers::parallel_for(*pool_, chunks.size(), process_chunk);
+        }
+
+    private:
+        helpers::ThreadPool* pool_;
+        TFunction function_;
+        TStages stages_;
+    };
+
+    // folds the pipeline with an associative operation - chunk results are combined in order,
+    // so the operation does not have to be commutative
+    template <typename T, typename TOperation, typename TStages>
+    class ParReduce : public Pipeable<ParReduce<T, TOperation, TStages>>
+    {
+    public:
+        ParReduce(helpers::ThreadPool& pool, T init, TOperation operation, TStages stages)
+            : pool_{&pool}
+            , init_{std::move(init)}
+            , operation_{std::move(operation)}
+            , stages_{std::move(stages)}
+        { }
+
+        template <ChunkableRange TRange>
+            requires std::ranges::input_range<detail::StagesResult<TStages, TRange>>
+        T operator()(TRange&& range) const
+        {
+            const auto chunks = detail::split_into_chunks(range, pool_->size() + 1);
+            std::vector<std::optional<T>> partial_results(chunks.size());
+
+            auto process_chunk = [&](std::size_t index) {
+                auto chunk = chunks[index];
+                std::optional<T> result;
+                for (auto&& item : std::invoke(stages_, chunk))
+                {
+                    if (result)
+                        *result = std::invoke(operation_, std::move(*result), std::forward<decltype(item)>(item));
+                    else
+                        result.emplace(std::forward<decltype(item)>(item));
+                }
+                partial_results[index] = std::move(result);
+            };
+
+            helpers::parallel_for(*pool_, chunks.size(), process_chunk);
+
+            T result = init_;
+            for (auto& partial_result : partial_results)
+            {
+                if (partial_result)
+                    result = std::invoke(operation_, std::move(result), std::move(*partial_result));
+            }
+
+            return result;
+        }
+
+    private:
+        helpers::ThreadPool* pool_;
+        T init_;
+        TOperation operation_;
+        TStages stages_;
+    };
+
+    // collects the pipeline into a container - items keep the order of the sequential pipeline
+    template <template <typename...> class TContainer, typename TStages>
+    class ParTo : public Pipeable<ParTo<TContainer, TStages>>
+    {
+    public:
+        ParTo(helpers::ThreadPool& pool, TStages stages)
+            : pool_{&pool}
+            , stages_{std::move(stages)}
+        { }
+
+        template <ChunkableRange TRange>
+            requires std::ranges::input_range<detail::StagesResult<TStages, TRange>>
+        auto operator()(TRange&& range) const
+        {
+            using Value = std::ranges::range_value_t<detail::StagesResult<TStages, TRange>>;
+
+            const auto chunks = detail::split_into_chunks(range, pool_->size() + 1);
+            std::vector<std::vector<Value>> parts(chunks.size());
+
+            auto process_chunk = [&](std::size_t index) {
+                auto chunk = chunks[index];
+                auto&& items = std::invoke(stages_, chunk);
+                if constexpr (std::ranges::sized_range<decltype(items)>)
+                    parts[index].reserve(std::ranges::size(items));
+                for (auto&& item : items)
+                    parts[index].emplace_back(std::forward<decltype(item)>(item));
+            };
+
+            helpers::parallel_for(*pool_, chunks.size(), process_chunk);
+
+            TContainer<Value> result;
+            if constexpr (requires { result.reserve(std::size_t{}); })
+            {
+                std::size_t total_size = 0;
+                for (const auto& part : parts)
+                    total_size += part.size();
+                result.reserve(total_size);
+            }
+
+            for (auto& part : parts)
+                result.insert(result.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+
+            return result;
+        }
+
+    private:
+        helpers::ThreadPool* pool_;
+        TStages stages_;
+    };
+
+    // rng | par_for_each(pool, f [, stages])
+    template <typename TFunction, typename TStages = detail::AllStages>
+    auto par_for_each(helpers::ThreadPool& pool, TFunction function, TStages stages = {})
+    {
+        return ParForEach<TFunction, TStages>{pool, std::move(function), std::move(stages)};
+    }
+
+    // rng | par_reduce(pool, init, op [, stages])
+    template <typename T, typename TOperation = std::plus<>, typename TStages = detail::AllStages>
+    auto par_reduce(helpers::ThreadPool& pool, T init, TOperation operation = {}, TStages stages = {})
+    {
+        return ParReduce<T, TOperation, TStages>{pool, std::move(init), std::move(operation), std::move(stages)};
+    }
+
+    // rng | par_to<std::vector>(pool [, stages])
+    template <template <typename...> class TContainer, typename TStages = detail::AllStages>
+    auto par_to(helpers::ThreadPool& pool, TStages stages = {})
+    {
+        return ParTo<TContainer, TStages>{pool, std::move(stages)};
+    }
+} // namespace RangesExt
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef PIPEABLE_HPP
+#define PIPEABLE_HPP
+
+#include <concepts>
+#include <ranges>
+#include <utility>
+
+namespace RangesExt
+{
+    // stand-in for C++23 std::ranges::range_adaptor_closure (not available in libstdc++ 12)
+    // - a closure deriving from Pipeable<Closure> may be applied with `range | closure` == `closure(range)`
+    template <typename TClosure>
+    struct Pipeable
+    {
+        template <std::ranges::range TRange>
+            requires std::invocable<const TClosure&, TRange>
+        friend decltype(auto) operator|(TRange&& range, const TClosure& closure)
+        {
+            return closure(std::forward<TRange>(range));
+        }
+    };
+} // namespace RangesExt
+
+#endif
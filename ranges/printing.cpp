@@ -0,0 +1,210 @@
+#include <catch2/catch_test_macros.hpp>
+#include <export.hpp>
+#include <helpers.hpp>
+#include <charconv>
+#include <cstring>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    struct Celsius
+    {
+        double value;
+
+        friend std::ostream& operator<<(std::ostream& out, const Celsius& temp)
+        {
+            return out << temp.value << "C";
+        }
+    };
+
+    // an item which prints its members with helpers::print
+    struct Group
+    {
+        std::vector<int> members;
+        int fd;
+
+        friend std::ostream& operator<<(std::ostream& out, const Group& group)
+        {
+            helpers::print(group.members, "members", {.fd = group.fd});
+            return out << "group";
+        }
+    };
+
+    struct Person
+    {
+        std::string name;
+        uint8_t age;
+    };
+
+    auto export_fields(const Person& p)
+    {
+        return std::tie(p.name, p.age);
+    }
+
+    template <typename F>
+    std::string capture_fd_output(F print_to_fd)
+    {
+        std::FILE* file = std::tmpfile();
+        print_to_fd(::fileno(file));
+
+        std::string content(static_cast<size_t>(std::ftell(file)), '\0');
+        std::rewind(file);
+        content.resize(std::fread(content.data(), 1, content.size(), file));
+        std::fclose(file);
+
+        return content;
+    }
+} // namespace
+
+TEST_CASE("buffered print")
+{
+    SECTION("the same output as streaming every item")
+    {
+        std::vector<double> numbers = {1, -2.5, 3.14159265, 1e20};
+        std::list words = {"one"s, "two"s};
+        std::vector temperatures = {Celsius{21.5}, Celsius{-3}};
+
+        auto numbers_output = capture_fd_output([&](int fd) { helpers::print(numbers, "numbers", {.fd = fd}); });
+        auto words_output = capture_fd_output([&](int fd) { helpers::print(words, "words", {.fd = fd}); });
+        auto temperatures_output = capture_fd_output([&](int fd) { helpers::print(temperatures, "temp", {.fd = fd}); });
+
+        std::ostringstream expected_numbers;
+        expected_numbers << "numbers = [";
+        for (double x : numbers)
+            expected_numbers << x << " ";
+        expected_numbers << "]\n";
+
+        CHECK(numbers_output == expected_numbers.str());
+        CHECK(words_output == "words = [\"one\" \"two\" ]\n");
+        CHECK(temperatures_output == "temp = [21.5C -3C ]\n");
+    }
+
+    SECTION("print called while printing an item")
+    {
+        auto output = capture_fd_output([](int fd) {
+            helpers::print(std::vector{Group{{1, 2}, fd}}, "groups", {.fd = fd});
+        });
+
+        CHECK(output == "groups = [members = [1 2 ]\ngroup ]\n");
+    }
+
+    SECTION("separator & limit")
+    {
+        auto output = capture_fd_output([](int fd) {
+            helpers::print(std::views::iota(1, 1'000'000), "iota", {.separator = ", ", .limit = 3, .fd = fd});
+        });
+
+        CHECK(output == "iota = [1, 2, 3, ..., ]\n");
+    }
+
+    SECTION("large ranges are flushed in chunks")
+    {
+        auto output = capture_fd_output([](int fd) { helpers::print(std::views::iota(0, 100'000), "iota", {.fd = fd}); });
+
+        CHECK(output.size() > helpers::detail::PrintBuffer::flush_threshold);
+        CHECK(output.starts_with("iota = [0 1 2 "));
+        CHECK(output.ends_with("99998 99999 ]\n"));
+    }
+}
+
+TEST_CASE("structured export")
+{
+    using namespace helpers::exporting;
+
+    std::vector<Person> people = {{"Jan", 33}, {"Kowalski, \"Jr\"", 42}};
+
+    SECTION("CSV")
+    {
+        auto csv = capture_fd_output([&](int fd) {
+            BlockWriter out{fd};
+            export_csv(out, people, {"name", "age"});
+        });
+
+        CHECK(csv == "name,age\nJan,33\n\"Kowalski, \"\"Jr\"\"\",42\n");
+    }
+
+    SECTION("CSV - numbers split across blocks")
+    {
+        auto csv = capture_fd_output([](int fd) {
+            BlockWriter out{fd, 4096};
+            export_csv(out, std::views::iota(0, 10'000) | std::views::transform([](int x) { return std::pair{x, x * 0.25}; }));
+        });
+
+        std::string expected;
+        for (int x = 0; x < 10'000; ++x)
+        {
+            char value[32];
+            expected += std::to_string(x) + ",";
+            expected.append(value, std::to_chars(std::begin(value), std::end(value), x * 0.25).ptr);
+            expected += "\n";
+        }
+
+        CHECK(csv == expected);
+    }
+
+    SECTION("JSON Lines")
+    {
+        std::map<std::string, double> prices = {{"ipad", 1.5}, {"nan", std::numeric_limits<double>::quiet_NaN()}};
+
+        auto objects = capture_fd_output([&](int fd) {
+            BlockWriter out{fd};
+            export_json_lines(out, people, {"name", "age"});
+        });
+        auto pairs = capture_fd_output([&](int fd) {
+            BlockWriter out{fd};
+            export_json_lines(out, prices);
+        });
+        auto numbers = capture_fd_output([](int fd) {
+            BlockWriter out{fd};
+            export_json_lines(out, std::views::iota(1, 4));
+        });
+
+        CHECK(objects == "{\"name\":\"Jan\",\"age\":33}\n{\"name\":\"Kowalski, \\\"Jr\\\"\",\"age\":42}\n");
+        CHECK(pairs == "[\"ipad\",1.5]\n[\"nan\",null]\n");
+        CHECK(numbers == "1\n2\n3\n");
+    }
+
+    SECTION("binary columnar - streamed in row groups")
+    {
+        auto data = capture_fd_output([](int fd) {
+            BlockWriter out{fd, 4096};
+            export_binary_columnar(out, std::views::iota(0, 10'000) | std::views::transform([](int x) { return std::pair{x, x * 0.5}; }), 4'096);
+        });
+
+        // magic + column count + 2 column types + 3 row groups + terminator
+        CHECK(data.size() == 8 + 4 + 2 + 3 * 4 + 10'000 * (sizeof(int) + sizeof(double)) + 4);
+        CHECK(data.starts_with(std::string_view{"HLPCOL1\0", 8}));
+
+        uint32_t first_group_rows;
+        std::memcpy(&first_group_rows, data.data() + 14, sizeof(first_group_rows));
+        CHECK(first_group_rows == 4'096);
+
+        int first_group_last_value;
+        std::memcpy(&first_group_last_value, data.data() + 18 + 4'095 * sizeof(int), sizeof(int));
+        CHECK(first_group_last_value == 4'095);
+    }
+
+    SECTION("binary columnar - row group size has to fit the row count")
+    {
+        BlockWriter out{"/dev/null"};
+        CHECK_THROWS_AS(export_binary_columnar(out, people, 0), std::invalid_argument);
+        CHECK_THROWS_AS(export_binary_columnar(out, people, size_t{1} << 32), std::invalid_argument);
+    }
+
+    SECTION("binary columnar - strings")
+    {
+        auto data = capture_fd_output([&](int fd) {
+            BlockWriter out{fd};
+            export_binary_columnar(out, people);
+        });
+
+        CHECK(data.size() == 8 + 4 + 2 + 4 + 2 * sizeof(uint32_t) + people[0].name.size() + people[1].name.size() + 2 + 4);
+    }
+}
@@ -0,0 +1,79 @@
+#include "simd.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // the same result as the element-at-a-time view
+    template <typename T, typename TPredicate>
+    void check_filter_to(const std::vector<T>& data, TPredicate pred)
+    {
+        std::vector<T> expected;
+        std::ranges::copy(data | std::views::filter(pred), std::back_inserter(expected));
+
+        CHECK((data | RangesExt::filter_to(pred)) == expected);
+    }
+
+    template <typename T>
+    std::vector<T> numbers(int count)
+    {
+        std::vector<T> result(count);
+        for (int i = 0; i < count; ++i)
+            result[i] = static_cast<T>((i * 7919) % 1000 - 500);
+        return result;
+    }
+}
+
+TEST_CASE("filter_to - contiguous arithmetic ranges")
+{
+    for (int size : {0, 1, 7, 8, 9, 15, 16, 17, 1000, 1003, 5000})
+    {
+        check_filter_to(numbers<int>(size), [](int x) { return x % 3 == 0; });
+        check_filter_to(numbers<std::uint32_t>(size), [](std::uint32_t x) { return x > 100; });
+        check_filter_to(numbers<float>(size), [](float x) { return x < 0.5f; });
+        check_filter_to(numbers<double>(size), [](double x) { return x >= -10.0 && x <= 400.0; });
+        check_filter_to(numbers<std::int64_t>(size), [](std::int64_t x) { return x & 1; });
+        check_filter_to(numbers<std::int16_t>(size), [](std::int16_t x) { return x != 0; });
+    }
+
+    SECTION("none and all selected")
+    {
+        auto data = numbers<int>(100);
+        CHECK((data | RangesExt::filter_to([](int) { return false; })).empty());
+        CHECK((data | RangesExt::filter_to([](int) { return true; })) == data);
+    }
+}
+
+TEST_CASE("filter_to - other ranges fall back to copy_if")
+{
+    std::list<int> numbers{1, 2, 3, 4, 5, 6};
+    CHECK((numbers | RangesExt::filter_to([](int x) { return x % 2 == 0; })) == std::vector{2, 4, 6});
+
+    std::vector<std::string> words{"one", "two", "three"};
+    CHECK((words | RangesExt::filter_to([](const std::string& w) { return w.size() == 3; })) == std::vector<std::string>{"one", "two"});
+
+    CHECK((std::views::iota(1, 10) | RangesExt::filter_to([](int x) { return x > 6; })) == std::vector{7, 8, 9});
+}
+
+TEST_CASE("transform_to")
+{
+    std::vector<int> data(1001);
+    std::iota(data.begin(), data.end(), -500);
+
+    auto squares = data | RangesExt::transform_to([](int x) { return static_cast<long long>(x) * x; });
+    REQUIRE(squares.size() == 1001);
+    CHECK(squares.front() == 250'000);
+    CHECK(squares[500] == 0);
+
+    auto halves = data | RangesExt::transform_to([](int x) { return x / 2.0; });
+    CHECK(halves.back() == 250.0);
+
+    auto texts = data | std::views::take(3) | RangesExt::transform_to([](int x) { return std::to_string(x); });
+    CHECK(texts == std::vector<std::string>{"-500", "-499", "-498"});
+}
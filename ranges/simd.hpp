@@ -0,0 +1,268 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include "pipeable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// batch-aware counterparts of views::filter and views::transform - eager, the result is a std::vector
+//
+//   auto evens = data | RangesExt::filter_to([](int x) { return x % 2 == 0; });
+//   auto scaled = data | RangesExt::transform_to([](int x) { return x * 3; });
+//
+// - contiguous ranges of arithmetic types are processed in blocks over raw pointers:
+//   the predicate is evaluated for a whole block into a selection mask and the selected elements
+//   are written with a compress-store (AVX-512 / AVX2 permutation, branch-free scalar code otherwise)
+// - any other input range falls back to the element-at-a-time algorithms
+namespace RangesExt
+{
+    template <typename TRange>
+    concept ContiguousArithmeticRange = std::ranges::contiguous_range<TRange> && std::ranges::sized_range<TRange>
+        && std::is_arithmetic_v<std::ranges::range_value_t<TRange>> && !std::same_as<std::ranges::range_value_t<TRange>, bool>;
+
+    namespace detail
+    {
+        // elements of T per compress-store - 0 if there is no vector compress-store for T
+        template <typename T>
+        constexpr std::size_t simd_block_size()
+        {
+#if defined(__AVX512F__)
+            if constexpr (sizeof(T) == 4 || sizeof(T) == 8)
+                return 64 / sizeof(T);
+#elif defined(__AVX2__)
+            if constexpr (sizeof(T) == 4 || sizeof(T) == 8)
+                return 32 / sizeof(T);
+#endif
+            return 0;
+        }
+
+        // evaluated for a batch of elements at once - the predicate runs in a fixed-length loop the compiler can vectorize
+        inline constexpr std::size_t selection_batch_size = 256;
+
+        inline constexpr std::size_t filter_buffer_size = 8 * selection_batch_size;
+
+        // bits of the 32 selection flags starting at flags (0 or 1 each)
+        inline std::uint32_t pack_selection_flags(const std::uint8_t* flags)
+        {
+#if defined(__AVX2__)
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(flags));
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(bytes, _mm256_setzero_si256())));
+#else
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < 32; ++i)
+                mask |= std::uint32_t{flags[i]} << i;
+            return mask;
+#endif
+        }
+
+#if defined(__AVX512F__)
+        // writes the selected elements of the block contiguously to out - returns their number
+        template <typename T>
+        std::size_t compress_store(const T* block, std::uint32_t mask, T* out)
+        {
+            if constexpr (sizeof(T) == 4)
+                _mm512_mask_compressstoreu_epi32(out, static_cast<__mmask16>(mask), _mm512_loadu_si512(block));
+            else
+                _mm512_mask_compressstoreu_epi64(out, static_cast<__mmask8>(mask), _mm512_loadu_si512(block));
+
+            return static_cast<std::size_t>(std::popcount(mask));
+        }
+#elif defined(__AVX2__)
+        // for every mask: indices of the 32-bit lanes to move to the front, packed 3 bits per lane
+        template <typename T>
+        constexpr auto make_compress_permutations()
+        {
+            constexpr std::size_t block_size = 32 / sizeof(T);
+            constexpr std::size_t lanes_per_element = sizeof(T) / 4;
+
+            std::array<std::uint32_t, std::size_t{1} << block_size> permutations{};
+            for (std::size_t mask = 0; mask < permutations.size(); ++mask)
+            {
+                std::size_t lane = 0;
+                for (std::size_t element = 0; element < block_size; ++element)
+                {
+                    if (mask & (std::size_t{1} << element))
+                    {
+                        for (std::size_t part = 0; part < lanes_per_element; ++part, ++lane)
+                            permutations[mask] |= static_cast<std::uint32_t>(element * lanes_per_element + part) << (3 * lane);
+                    }
+                }
+            }
+
+            return permutations;
+        }
+
+        template <typename T>
+        inline constexpr auto compress_permutations = make_compress_permutations<T>();
+
+        // writes the selected elements of the block to the front of out - all 32 bytes are stored,
+        // the bytes past the selected elements are overwritten by the next block
+        template <typename T>
+        std::size_t compress_store(const T* block, std::uint32_t mask, T* out)
+        {
+            const __m256i packed = _mm256_set1_epi32(static_cast<int>(compress_permutations<T>[mask]));
+            const __m256i permutation = _mm256_and_si256(_mm256_srlv_epi32(packed, _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21)), _mm256_set1_epi32(7));
+
+            const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(values, permutation));
+
+            return static_cast<std::size_t>(std::popcount(mask));
+        }
+#endif
+
+        // copies the elements satisfying pred to out (room for size elements) - returns their number
+        template <typename T, typename TPredicate>
+        std::size_t select(const T* first, std::size_t size, T* out, const TPredicate& pred)
+        {
+            std::size_t count = 0;
+            std::size_t i = 0;
+
+            if constexpr (constexpr std::size_t block_size = simd_block_size<T>(); block_size > 0)
+            {
+                constexpr std::uint32_t block_mask = static_cast<std::uint32_t>((std::uint64_t{1} << block_size) - 1);
+
+                for (; i + selection_batch_size <= size; i += selection_batch_size)
+                {
+                    const T* batch = first + i;
+
+                    alignas(32) std::array<std::uint8_t, selection_batch_size> flags;
+                    for (std::size_t j = 0; j < selection_batch_size; ++j)
+                        flags[j] = static_cast<bool>(std::invoke(pred, batch[j]));
+
+                    for (std::size_t j = 0; j < selection_batch_size; j += 32)
+                    {
+                        const std::uint32_t mask = pack_selection_flags(flags.data() + j);
+                        for (std::size_t block = 0; block < 32; block += block_size)
+                            count += compress_store(batch + j + block, (mask >> block) & block_mask, out + count);
+                    }
+                }
+            }
+
+            // branch-free - every element is stored, the count advances only for the selected ones
+            for (; i < size; ++i)
+            {
+                out[count] = first[i];
+                count += static_cast<bool>(std::invoke(pred, first[i]));
+            }
+
+            return count;
+        }
+
+        // plain loop over pointers - no iterator indirection, so arithmetic operations are auto-vectorized
+        template <typename T, typename TResult, typename TFunction>
+        void transform(const T* first, std::size_t size, TResult* out, const TFunction& function)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                out[i] = std::invoke(function, first[i]);
+        }
+    } // namespace detail
+
+    template <typename TPredicate>
+    class FilterTo : public Pipeable<FilterTo<TPredicate>>
+    {
+    public:
+        explicit FilterTo(TPredicate pred)
+            : pred_{std::move(pred)}
+        { }
+
+        template <std::ranges::input_range TRange>
+            requires std::predicate<const TPredicate&, std::ranges::range_reference_t<TRange>>
+        auto operator()(TRange&& range) const
+        {
+            using Value = std::ranges::range_value_t<TRange>;
+
+            std::vector<Value> result;
+
+            if constexpr (ContiguousArithmeticRange<TRange>)
+            {
+                // selected through an L1-resident buffer - resizing the result up front would zero-fill it first
+                alignas(64) std::array<Value, detail::filter_buffer_size> buffer;
+
+                const Value* first = std::ranges::data(range);
+                const std::size_t size = std::ranges::size(range);
+                result.reserve(size);
+
+                for (std::size_t offset = 0; offset < size; offset += buffer.size())
+                {
+                    const std::size_t count = detail::select(first + offset, std::min(buffer.size(), size - offset), buffer.data(), pred_);
+                    result.insert(result.end(), buffer.data(), buffer.data() + count);
+                }
+            }
+            else
+            {
+                std::ranges::copy_if(range, std::back_inserter(result), std::cref(pred_));
+            }
+
+            return result;
+        }
+
+    private:
+        TPredicate pred_;
+    };
+
+    template <typename TFunction>
+    class TransformTo : public Pipeable<TransformTo<TFunction>>
+    {
+    public:
+        explicit TransformTo(TFunction function)
+            : function_{std::move(function)}
+        { }
+
+        template <std::ranges::input_range TRange>
+            requires std::regular_invocable<const TFunction&, std::ranges::range_reference_t<TRange>>
+        auto operator()(TRange&& range) const
+        {
+            using Result = std::remove_cvref_t<std::invoke_result_t<const TFunction&, std::ranges::range_reference_t<TRange>>>;
+
+            std::vector<Result> result;
+
+            if constexpr (ContiguousArithmeticRange<TRange> && std::is_arithmetic_v<Result>)
+            {
+                result.resize(std::ranges::size(range));
+                detail::transform(std::ranges::data(range), std::ranges::size(range), result.data(), function_);
+            }
+            else
+            {
+                if constexpr (std::ranges::sized_range<TRange>)
+                    result.reserve(std::ranges::size(range));
+                std::ranges::transform(range, std::back_inserter(result), std::cref(function_));
+            }
+
+            return result;
+        }
+
+    private:
+        TFunction function_;
+    };
+
+    // rng | filter_to(pred) - std::vector of the elements satisfying pred
+    template <typename TPredicate>
+    auto filter_to(TPredicate pred)
+    {
+        return FilterTo<TPredicate>{std::move(pred)};
+    }
+
+    // rng | transform_to(f) - std::vector of f(element)
+    template <typename TFunction>
+    auto transform_to(TFunction function)
+    {
+        return TransformTo<TFunction>{std::move(function)};
+    }
+} // namespace RangesExt
+
+#endif
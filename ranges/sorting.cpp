@@ -0,0 +1,368 @@
+#include <catch2/catch_test_macros.hpp>
+#include <helpers.hpp>
+#include <sort_keys.hpp>
+#include <sorting.hpp>
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    template <typename T>
+    std::vector<T> random_values(size_t size, T low = std::numeric_limits<T>::min(), T high = std::numeric_limits<T>::max())
+    {
+        std::mt19937_64 rnd{42};
+        std::uniform_int_distribution<T> distr{low, high};
+
+        std::vector<T> values(size);
+        std::ranges::generate(values, [&] { return distr(rnd); });
+        return values;
+    }
+
+    // random values mixed with infinities, zeros of both signs, denormals and NaNs with random signs and payloads
+    template <std::floating_point T>
+    std::vector<T> random_floats(size_t size)
+    {
+        using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        using Limits = std::numeric_limits<T>;
+
+        const std::vector<T> specials = {Limits::infinity(), -Limits::infinity(), T{0}, -T{0}, Limits::denorm_min(), -Limits::denorm_min(), Limits::max(), Limits::lowest()};
+
+        std::mt19937_64 rnd{7};
+        std::uniform_real_distribution<T> distr{-1000, 1000};
+
+        std::vector<T> values(size);
+        for (auto& value : values)
+        {
+            switch (rnd() % 8)
+            {
+            case 0:
+                value = specials[rnd() % specials.size()];
+                break;
+            case 1: // exponent all ones and a random non-zero payload
+                value = std::bit_cast<T>(static_cast<Bits>(std::bit_cast<Bits>(Limits::infinity()) | (static_cast<Bits>(rnd()) >> (Limits::digits + 1)) | Bits{1} | (rnd() % 2 ? std::bit_cast<Bits>(-T{0}) : Bits{0})));
+                break;
+            default:
+                value = distr(rnd);
+            }
+        }
+        return values;
+    }
+
+    template <typename T>
+    auto bits_of(const std::vector<T>& values)
+    {
+        using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+        std::vector<Bits> bits;
+        for (T value : values)
+            bits.push_back(std::bit_cast<Bits>(value));
+        return bits;
+    }
+
+    // the order of the "std::strong_order & NaN" test in compare/comparisons.cpp
+    template <typename T>
+    std::vector<T> strong_order_sorted(std::vector<T> values, bool descending = false)
+    {
+        std::sort(values.begin(), values.end(), [=](auto a, auto b) { return descending ? std::strong_order(a, b) > 0 : std::strong_order(a, b) < 0; });
+        return values;
+    }
+
+    struct Person
+    {
+        std::string name;
+        uint8_t age;
+
+        auto operator<=>(const Person&) const = default;
+    };
+
+    struct Gadget
+    {
+        std::string name;
+        double price;
+
+        std::strong_ordering operator<=>(const Gadget& other) const
+        {
+            if (auto cmp_result = name <=> other.name; cmp_result != 0)
+                return cmp_result;
+            return std::strong_order(price, other.price);
+        }
+
+        bool operator==(const Gadget& other) const = default;
+    };
+
+    struct Reading
+    {
+        double value;
+        std::string sensor;
+
+        auto operator<=>(const Reading&) const = default;
+    };
+
+    std::vector<Person> random_people(size_t size)
+    {
+        const std::vector<std::string> names = {"Jan", "Janek", std::string("Jan\0\0", 5), "Adam", "Anna", "Anna Maria Kowalska-Nowak", "Anna Maria Kowalska-Nowicka", ""};
+
+        std::mt19937_64 rnd{665};
+        std::vector<Person> people;
+        for (size_t i = 0; i < size; ++i)
+            people.push_back(Person{names[rnd() % names.size()], static_cast<uint8_t>(rnd() % 100)});
+        return people;
+    }
+
+    template <typename T, typename TCompare = std::ranges::less>
+    void check_radix_sort(std::vector<T> values, TCompare comp = {})
+    {
+        auto expected = values;
+        std::ranges::sort(expected, comp);
+
+        helpers::sorting::radix_sort(values, comp);
+        CHECK(values == expected);
+    }
+}
+
+TEST_CASE("radix_key preserves the order")
+{
+    using helpers::sorting::radix_key;
+
+    static_assert(radix_key(std::numeric_limits<int>::min()) == 0u);
+    static_assert(radix_key(-1) < radix_key(0));
+    static_assert(radix_key(std::int8_t{127}) == 255u);
+    static_assert(radix_key(42u) == 42u);
+
+    static_assert(radix_key(-std::numeric_limits<double>::infinity()) < radix_key(-1.0));
+    static_assert(radix_key(-1.0) < radix_key(-0.0));
+    static_assert(radix_key(-0.0) < radix_key(0.0));
+    static_assert(radix_key(0.0) < radix_key(std::numeric_limits<double>::denorm_min()));
+    static_assert(radix_key(1.5f) < radix_key(std::numeric_limits<float>::infinity()));
+    static_assert(radix_key(std::numeric_limits<float>::infinity()) < radix_key(std::numeric_limits<float>::quiet_NaN()));
+}
+
+TEST_CASE("radix_sort")
+{
+    SECTION("small-range ints from create_numeric_dataset")
+    {
+        check_radix_sort(helpers::create_numeric_dataset(100'000));
+        check_radix_sort(helpers::create_numeric_dataset(100'000), std::greater{});
+    }
+
+    SECTION("full-range keys")
+    {
+        for (size_t size : {0, 1, 255, 256, 10'000, 100'000})
+        {
+            check_radix_sort(random_values<int>(size));
+            check_radix_sort(random_values<std::int64_t>(size), std::ranges::greater{});
+            check_radix_sort(random_values<std::uint64_t>(size));
+            check_radix_sort(random_values<std::int16_t>(size), std::greater<std::int16_t>{});
+        }
+    }
+
+    SECTION("extreme values")
+    {
+        std::vector<int> values(1000, 0);
+        values[10] = std::numeric_limits<int>::min();
+        values[20] = std::numeric_limits<int>::max();
+        values[30] = -1;
+        check_radix_sort(values);
+    }
+
+    SECTION("other comparators fall back to std::ranges::sort")
+    {
+        check_radix_sort(random_values<int>(1000), [](int a, int b) { return std::abs(a % 100) < std::abs(b % 100); });
+
+        std::vector words = {"twenty-two"s, "a"s, "abc"s, "b"s, "one"s, "aa"s};
+        helpers::sorting::radix_sort(words);
+        CHECK(std::ranges::is_sorted(words));
+    }
+}
+
+TEST_CASE("radix_sort - floating point values in the order of std::strong_order")
+{
+    using helpers::sorting::StrongOrderGreater;
+    using helpers::sorting::StrongOrderLess;
+
+    for (size_t size : {0, 1, 100, 10'000, 100'000})
+    {
+        auto doubles = random_floats<double>(size);
+        const auto expected = strong_order_sorted(doubles);
+
+        helpers::sorting::radix_sort(doubles, StrongOrderLess{});
+        CHECK(bits_of(doubles) == bits_of(expected)); // NaNs compare unequal - the bits are compared
+
+        auto floats = random_floats<float>(size);
+        const auto expected_descending = strong_order_sorted(floats, true);
+
+        helpers::sorting::radix_sort(floats, StrongOrderGreater{});
+        CHECK(bits_of(floats) == bits_of(expected_descending));
+    }
+
+    SECTION("less orders NaNs as strong_order does")
+    {
+        auto doubles = random_floats<double>(1000);
+        const auto expected = strong_order_sorted(doubles);
+
+        helpers::sorting::radix_sort(doubles);
+        CHECK(bits_of(doubles) == bits_of(expected));
+    }
+
+    SECTION("parallel_sort")
+    {
+        helpers::ThreadPool pool{3};
+
+        auto doubles = random_floats<double>(300'000);
+        const auto expected = strong_order_sorted(doubles);
+
+        helpers::sorting::parallel_sort(pool, doubles, StrongOrderLess{});
+        CHECK(bits_of(doubles) == bits_of(expected));
+    }
+}
+
+TEST_CASE("sort_by_key - projection is evaluated once per element")
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 1000; ++i)
+        words.push_back(std::string(static_cast<size_t>(i * 7919 % 50), 'a') + std::to_string(i));
+
+    auto expected = words;
+    std::ranges::stable_sort(expected, std::less{}, [](const std::string& str) { return str.size(); });
+
+    int calls = 0;
+    helpers::sorting::sort_by_key(words, [&calls](const std::string& str) { ++calls; return str.size(); });
+
+    CHECK(words == expected); // stable
+    CHECK(calls == 1000);
+
+    SECTION("descending, non-integral key")
+    {
+        calls = 0;
+        helpers::sorting::sort_by_key(words, [&calls](const std::string& str) { ++calls; return str.substr(str.size() - 1); }, std::greater{});
+
+        CHECK(std::ranges::is_sorted(words, std::greater{}, [](const std::string& str) { return str.back(); }));
+        CHECK(calls == 1000);
+    }
+}
+
+TEST_CASE("sort_by_key - move-only elements")
+{
+    std::vector<std::unique_ptr<int>> values;
+    for (int value : {5, 3, 9, 1, 7})
+        values.push_back(std::make_unique<int>(value));
+
+    helpers::sorting::sort_by_key(values, [](const std::unique_ptr<int>& ptr) { return *ptr; });
+
+    std::vector<int> result;
+    for (const auto& ptr : values)
+        result.push_back(*ptr);
+    CHECK(result == std::vector{1, 3, 5, 7, 9});
+}
+
+TEST_CASE("parallel_sort")
+{
+    helpers::ThreadPool pool{3};
+
+    SECTION("duplicated small-range ints")
+    {
+        auto data = helpers::create_numeric_dataset(500'000);
+        auto expected = data;
+        std::ranges::sort(expected, std::greater{});
+
+        helpers::sorting::parallel_sort(pool, data, std::greater{});
+        CHECK(data == expected);
+    }
+
+    SECTION("strings")
+    {
+        std::vector<std::string> words;
+        for (int value : random_values<int>(100'000))
+            words.push_back(std::to_string(value));
+
+        auto expected = words;
+        std::ranges::sort(expected);
+
+        helpers::sorting::parallel_sort(pool, words);
+        CHECK(words == expected);
+    }
+
+    SECTION("projection")
+    {
+        auto data = random_values<std::int64_t>(200'000);
+        auto by_low_bits = [](std::int64_t value) { return static_cast<std::uint16_t>(value); };
+
+        helpers::sorting::parallel_sort(pool, data, std::less{}, by_low_bits);
+        CHECK(std::ranges::is_sorted(data, std::less{}, by_low_bits));
+    }
+}
+
+TEST_CASE("normalized keys preserve the order of <=>")
+{
+    using helpers::sorting::make_normalized_key;
+
+    auto key_of = [](const Person& p) { return make_normalized_key(p.name, p.age); };
+
+    const auto people = random_people(200);
+
+    int violations = 0;
+    for (const auto& a : people)
+        for (const auto& b : people)
+            violations += key_of(a) < key_of(b) && !(a < b);
+    CHECK(violations == 0);
+
+    static_assert(make_normalized_key("Jan"sv, 23) < make_normalized_key("Jan"sv, 33));
+    static_assert(make_normalized_key("Jan"sv, 33) < make_normalized_key("Janek"sv, 33));
+
+    CHECK(make_normalized_key(-1.0) < make_normalized_key(-0.0));
+    CHECK(make_normalized_key(-0.0) == make_normalized_key(0.0)); // equivalent for <=>
+    CHECK(make_normalized_key(std::numeric_limits<double>::infinity()) < make_normalized_key(std::numeric_limits<double>::quiet_NaN()));
+    CHECK(make_normalized_key("ab"sv) < make_normalized_key("ab\0"sv));
+}
+
+TEST_CASE("sort_by_normalized_key")
+{
+    SECTION("defaulted <=>")
+    {
+        auto people = random_people(10'000);
+        auto expected = people;
+        std::ranges::sort(expected);
+
+        helpers::sorting::sort_by_normalized_key(people, [](const Person& p) { return std::tie(p.name, p.age); });
+        CHECK(people == expected);
+    }
+
+    SECTION("hand-written <=> with std::strong_order for doubles")
+    {
+        std::vector<Gadget> gadgets;
+        for (int i = 0; i < 1000; ++i)
+            gadgets.push_back(Gadget{i % 3 ? "ipad" : "smartwatch with a very long name", (i * 7919 % 200) / 4.0 - 25.0});
+
+        auto expected = gadgets;
+        std::ranges::sort(expected);
+
+        helpers::sorting::sort_by_normalized_key(gadgets, [](const Gadget& g) { return std::tie(g.name, g.price); });
+        CHECK(gadgets == expected);
+    }
+
+    SECTION("defaulted <=> with a double field - zeros of both signs are equivalent")
+    {
+        std::vector<Reading> readings = {{0.0, "a"}, {-0.0, "z"}, {-0.0, "b"}, {1.5, "a"}, {0.0, "c"}, {-1.5, "x"}};
+
+        helpers::sorting::sort_by_normalized_key(readings, [](const Reading& r) { return std::tie(r.value, r.sensor); });
+        CHECK(std::ranges::is_sorted(readings));
+    }
+
+    SECTION("descending by a prefix of the fields")
+    {
+        auto people = random_people(1000);
+
+        helpers::sorting::sort_by_normalized_key<8>(people, &Person::name, std::greater{});
+        CHECK(std::ranges::is_sorted(people, std::greater{}));
+    }
+}
@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+#include <helpers.hpp>
+#include <statistics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <vector>
+
+namespace
+{
+    double relative_error(double value, double expected)
+    {
+        return std::abs(value - expected) / std::abs(expected);
+    }
+
+    // 0..size-1 in random order
+    std::vector<int> shuffled_iota(int size)
+    {
+        std::vector<int> values(static_cast<size_t>(size));
+        std::iota(values.begin(), values.end(), 0);
+        std::ranges::shuffle(values, std::mt19937{665});
+        return values;
+    }
+
+    size_t distinct_count(std::vector<int> values)
+    {
+        std::ranges::sort(values);
+        return static_cast<size_t>(std::ranges::unique(values).begin() - values.begin());
+    }
+
+    // estimated rank of the quantile compared with its exact rank (values are 0..size-1)
+    double rank_error(const helpers::statistics::KllSketch<int>& sketch, double q, int size)
+    {
+        return std::abs(*sketch.quantile(q) - q * size) / size;
+    }
+}
+
+TEST_CASE("Moments - Welford")
+{
+    const auto data = helpers::create_numeric_dataset(100'000);
+
+    const double mean = std::accumulate(data.begin(), data.end(), 0.0) / static_cast<double>(data.size());
+    double sum_of_squares = 0.0;
+    for (int value : data)
+        sum_of_squares += (value - mean) * (value - mean);
+
+    helpers::statistics::Moments all;
+    helpers::statistics::Moments first_half;
+    helpers::statistics::Moments second_half;
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        all.add(data[i]);
+        (i < 30'000 ? first_half : second_half).add(data[i]);
+    }
+
+    CHECK(all.count() == data.size());
+    CHECK(std::abs(all.mean() - mean) < 1e-9);
+    CHECK(relative_error(all.variance(), sum_of_squares / static_cast<double>(data.size())) < 1e-9);
+
+    first_half.merge(second_half);
+    CHECK(first_half.count() == all.count());
+    CHECK(std::abs(first_half.mean() - all.mean()) < 1e-9);
+    CHECK(relative_error(first_half.sample_variance(), all.sample_variance()) < 1e-9);
+
+    CHECK(std::isnan(helpers::statistics::Moments{}.mean()));
+}
+
+TEST_CASE("MinMax")
+{
+    helpers::statistics::MinMax<int> left;
+    helpers::statistics::MinMax<int> right;
+    CHECK_FALSE(left.min().has_value());
+
+    for (int value : {5, -3, 8})
+        left.add(value);
+    for (int value : {10, 0})
+        right.add(value);
+
+    left.merge(right);
+    left.merge(helpers::statistics::MinMax<int>{});
+    CHECK(left.min() == -3);
+    CHECK(left.max() == 10);
+}
+
+TEST_CASE("KllSketch - quantiles in bounded memory")
+{
+    constexpr int size = 1'000'000;
+    const auto values = shuffled_iota(size);
+
+    helpers::statistics::KllSketch<int> sketch;
+    for (int value : values)
+        sketch.add(value);
+
+    CHECK(sketch.count() == size);
+    CHECK(sketch.retained() < 1000);
+
+    for (double q : {0.01, 0.1, 0.5, 0.9, 0.99})
+        CHECK(rank_error(sketch, q, size) < 0.01);
+
+    CHECK(std::abs(static_cast<double>(sketch.rank(size / 4)) - size / 4) / size < 0.01);
+
+    SECTION("merged sketches of the parts of the stream")
+    {
+        std::vector<helpers::statistics::KllSketch<int>> parts;
+        for (uint32_t seed = 1; seed <= 8; ++seed)
+            parts.emplace_back(helpers::statistics::KllSketch<int>::default_k, seed);
+
+        for (size_t i = 0; i < values.size(); ++i)
+            parts[i % parts.size()].add(values[i]);
+
+        for (size_t i = 1; i < parts.size(); ++i)
+            parts[0].merge(parts[i]);
+
+        CHECK(parts[0].count() == size);
+        CHECK(parts[0].retained() < 1000);
+        for (double q : {0.01, 0.5, 0.99})
+            CHECK(rank_error(parts[0], q, size) < 0.01);
+    }
+
+    SECTION("empty sketch")
+    {
+        CHECK_FALSE(helpers::statistics::KllSketch<double>{}.quantile(0.5).has_value());
+    }
+}
+
+TEST_CASE("DistinctCounter - exact mode, then HyperLogLog")
+{
+    using helpers::statistics::DistinctCounter;
+
+    SECTION("small cardinalities are counted exactly")
+    {
+        const auto data = helpers::create_numeric_dataset(100'000);
+
+        DistinctCounter<int> counter;
+        for (int value : data)
+            counter.add(value);
+
+        CHECK(counter.is_exact());
+        CHECK(counter.count() == distinct_count(data));
+    }
+
+    SECTION("large cardinalities are estimated")
+    {
+        for (int size : {10'000, 100'000, 2'000'000})
+        {
+            DistinctCounter<std::int64_t> counter;
+            for (int i = 0; i < size; ++i)
+                counter.add(i % 3 ? i : 0);
+
+            const double distinct = size - (size - 1) / 3;
+            CHECK_FALSE(counter.is_exact());
+            CHECK(relative_error(static_cast<double>(counter.count()), distinct) < 0.03);
+        }
+    }
+
+    SECTION("merging overlapping counters")
+    {
+        DistinctCounter<int> first;
+        DistinctCounter<int> second;
+        DistinctCounter<int> small;
+        for (int i = 0; i < 300'000; ++i)
+        {
+            first.add(i);
+            second.add(i + 200'000);
+        }
+        for (int i = 0; i < 100; ++i)
+            small.add(-i);
+
+        first.merge(second);
+        first.merge(small);
+        CHECK(relative_error(static_cast<double>(first.count()), 500'100.0) < 0.03);
+
+        small.merge(small);
+        CHECK(small.is_exact());
+        CHECK(small.count() == 100);
+    }
+}
+
+TEST_CASE("summarize - one pass over a stream, in parallel with merged parts")
+{
+    const auto data = helpers::create_numeric_dataset(1'000'000);
+    const auto [min, max] = std::ranges::minmax(data);
+
+    const auto summary = helpers::statistics::summarize(data | std::views::transform([](int value) { return value * 2; }));
+    CHECK(summary.moments.count() == data.size());
+    CHECK(summary.extremes.min() == 2 * min);
+    CHECK(summary.extremes.max() == 2 * max);
+    CHECK(summary.distinct.count() == distinct_count(data));
+
+    helpers::ThreadPool pool{3};
+    const auto parallel_summary = helpers::statistics::summarize(pool, data);
+
+    CHECK(parallel_summary.moments.count() == data.size());
+    CHECK(std::abs(parallel_summary.moments.mean() * 2 - summary.moments.mean()) < 1e-9);
+    CHECK(relative_error(parallel_summary.moments.variance() * 4, summary.moments.variance()) < 1e-9);
+    CHECK(parallel_summary.extremes.min() == min);
+    CHECK(parallel_summary.distinct.count() == distinct_count(data));
+    CHECK(std::abs(*parallel_summary.quantiles.quantile(0.5)) <= 3);
+}